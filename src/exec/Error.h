@@ -10,6 +10,8 @@ enum class [[nodiscard]] ErrCode : uint8_t {
     Cancelled,
     Exhausted,
     Abandoned,
+    Deadlock,
+    Lagged,
     Success,
 };
 
@@ -1,8 +1,11 @@
 #pragma once
 
+#include "exec/config.h"
+
 #include <supp/IntrusiveForwardList.h>
 
 #include <concepts>
+#include <cstdint>
 
 namespace exec {
 
@@ -10,6 +13,13 @@ class [[nodiscard]] Runnable : public supp::IntrusiveForwardListNode<> {
  public:
     virtual ~Runnable() = default;
     virtual void run() = 0;
+
+#if EXEC_PROFILE
+ private:
+    uint32_t postedAt_ = 0;  // microseconds, set by SystemExecutor
+
+    friend class SystemExecutor;
+#endif
 };
 
 [[maybe_unused]] static constexpr Runnable* noop = nullptr;
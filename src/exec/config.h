@@ -0,0 +1,45 @@
+#pragma once
+
+// -DEXEC_USE_TRACE records coroutine, executor, timer and service events, see exec/trace/trace.h
+#ifdef EXEC_USE_TRACE
+#define EXEC_TRACE 1
+#else
+#define EXEC_TRACE 0
+#endif
+
+// Number of trace records kept, older ones are overwritten
+#ifndef EXEC_TRACE_CAPACITY
+#define EXEC_TRACE_CAPACITY 128
+#endif
+
+// -DEXEC_USE_PROFILE makes OS measure the ticks of every service and SystemExecutor its queue,
+// see exec/os/ServiceStats.h and exec/executor/ExecutorStats.h
+#ifdef EXEC_USE_PROFILE
+#define EXEC_PROFILE 1
+#else
+#define EXEC_PROFILE 0
+#endif
+
+// -DEXEC_USE_AWAIT_PROFILE measures how long Async bodies stay suspended at each co_await,
+// see exec/coro/profile.h
+#ifdef EXEC_USE_AWAIT_PROFILE
+#define EXEC_AWAIT_PROFILE 1
+#else
+#define EXEC_AWAIT_PROFILE 0
+#endif
+
+// Number of co_await sites tracked, suspensions at other sites are only counted
+#ifndef EXEC_AWAIT_PROFILE_SITES
+#define EXEC_AWAIT_PROFILE_SITES 16
+#endif
+
+// Nesting of Async children started inline by Async::eager(), deeper ones start lazily
+#ifndef EXEC_EAGER_DEPTH
+#define EXEC_EAGER_DEPTH 8
+#endif
+
+// Bytes a select() resumer frame may take on top of its pointers, promise and parameters,
+// see exec/coro/par/select.h
+#ifndef EXEC_SELECT_FRAME_SLACK
+#define EXEC_SELECT_FRAME_SLACK (4 * sizeof(void*))
+#endif
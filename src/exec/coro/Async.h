@@ -4,8 +4,17 @@
 #include "exec/Unit.h"
 #include "exec/coro/cancel.h"
 
+#include "exec/config.h"
 #include "exec/coro/alloc.h"
 #include "exec/coro/traits.h"
+#include "exec/trace/trace.h"
+
+#if EXEC_AWAIT_PROFILE
+#include "exec/coro/profile.h"
+#include "exec/os/clock.h"
+
+#include <source_location>
+#endif
 
 #include <supp/ManualLifetime.h>
 #include <supp/NonCopyable.h>
@@ -15,6 +24,7 @@
 #include <logging/log.h>
 
 #include <coroutine>
+#include <cstdint>
 #include <cstdlib>
 #include <utility>
 
@@ -31,6 +41,62 @@ inline constexpr struct cancellation_state_t {
 
 namespace detail {
 
+// Async children running inline on the native stack, see Async::eager()
+inline uint8_t eagerDepth = 0;
+
+// Set when the innermost child running inline completes, before its caller's await_suspend() returns
+inline bool eagerCompleted = false;
+
+// A co_await that may suspend, as seen by the tracer and the await profiler.
+// Empty unless one of them is enabled.
+class SuspendPoint {
+ public:
+#if EXEC_AWAIT_PROFILE
+    explicit SuspendPoint(const std::source_location& loc) : loc_{loc} {}
+#else
+    SuspendPoint() = default;
+#endif
+
+    void suspended([[maybe_unused]] const void* frame) {
+#if EXEC_TRACE
+        trace::record(trace::Event::FrameSuspend, frame);
+        frame_ = frame;
+#endif
+#if EXEC_AWAIT_PROFILE
+        start_ = nowMicros();
+        suspended_ = true;
+#endif
+    }
+
+    void resumed() const {
+#if EXEC_TRACE
+        if (frame_ != nullptr) {
+            trace::record(trace::Event::FrameResume, frame_);
+        }
+#endif
+#if EXEC_AWAIT_PROFILE
+        if (suspended_) {
+            profile::recordAwait(loc_, nowMicros() - start_);
+        }
+#endif
+    }
+
+ private:
+#if EXEC_TRACE
+    const void* frame_ = nullptr;
+#endif
+#if EXEC_AWAIT_PROFILE
+    std::source_location loc_;
+    uint32_t start_ = 0;
+    bool suspended_ = false;
+#endif
+};
+
+// Completes the awaiting Async with the error, see resumeOn()
+struct AsyncError {
+    ErrCode code;
+};
+
 template <typename T>
 class AsyncPromiseBase : CancellationHandler {
     template <typename P>
@@ -40,6 +106,13 @@ class AsyncPromiseBase : CancellationHandler {
 
         auto continuation = promise.continuation_;
         self.destroy();
+
+        if (!continuation) {
+            // running inline, back to the caller's await_suspend()
+            eagerCompleted = true;
+            return std::noop_coroutine();
+        }
+
         return continuation;
     }
 
@@ -64,6 +137,8 @@ class AsyncPromiseBase : CancellationHandler {
                 return finalSuspend(self_p);
             }
 
+            point.suspended(&self_p.promise());
+
             if constexpr (std::same_as<void, decltype(impl.await_suspend(self_p))>) {
                 impl.await_suspend(self_p);
                 return std::noop_coroutine();
@@ -74,11 +149,13 @@ class AsyncPromiseBase : CancellationHandler {
 
         decltype(auto) await_resume() {
             DASSERT(!cancelled, "implementation bug");
+            point.resumed();
             return std::move(impl).await_resume();
         }
 
         const bool cancelled;
         A impl;
+        [[no_unique_address]] SuspendPoint point;
     };
 
     struct IgnoreCancellationGuard : supp::NonCopyable {
@@ -105,6 +182,21 @@ class AsyncPromiseBase : CancellationHandler {
         AsyncPromiseBase* self;
     };
 
+    struct ErrorAwaitable {
+        bool await_ready() const { return false; }
+
+        template <typename P>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<P> self_p) {
+            self->result_->setError(code);
+            return finalSuspend(self_p);
+        }
+
+        void await_resume() const { DASSERT(false, "implementation bug"); }
+
+        AsyncPromiseBase* self;
+        ErrCode code;
+    };
+
     struct CancellationStateAwaitable {
         bool await_ready() const { return true; }
         void await_suspend(std::coroutine_handle<>) const {}
@@ -113,7 +205,8 @@ class AsyncPromiseBase : CancellationHandler {
     };
 
  public:
-    AsyncPromiseBase() = default;
+    AsyncPromiseBase() { trace::record(trace::Event::FrameCreate, this); }
+    ~AsyncPromiseBase() { trace::record(trace::Event::FrameDestroy, this); }
 
     auto initial_suspend() { return std::suspend_always{}; }
     auto final_suspend() noexcept { return FinalAwaitable{}; }
@@ -123,20 +216,22 @@ class AsyncPromiseBase : CancellationHandler {
         abort();
     }
 
+#if EXEC_AWAIT_PROFILE
+    // loc is the location of the co_await
+    template <typename A>
+    auto await_transform(A&& awaitable, std::source_location loc = std::source_location::current()) {
+        return transform(std::forward<A>(awaitable), SuspendPoint{loc});
+    }
+#else
     template <typename A>
     auto await_transform(A&& awaitable) {
-        if constexpr (CancellableAwaitable<A>) {
-            if (up_slot_.isConnected()) [[likely]] {
-                awaitable.setCancellationSlot(down_sig_.slot());
-            }
-        }
-
-        return Callee<get_awaiter_t<A>>(
-            cancelled(), std::forward<A>(awaitable).operator co_await());
+        return transform(std::forward<A>(awaitable), SuspendPoint{});
     }
+#endif
 
     auto await_transform(ignore_cancellation_t) { return IgnoreCancellationAwaitable{this}; }
     auto await_transform(cancellation_state_t) { return CancellationStateAwaitable{this}; }
+    auto await_transform(AsyncError e) { return ErrorAwaitable{this, e.code}; }
 
     void setCancellationSlot(CancellationSlot slot) { up_slot_ = slot; }
 
@@ -146,6 +241,16 @@ class AsyncPromiseBase : CancellationHandler {
         up_slot_.installIfConnected(this);
     }
 
+    // Prepares to be resumed inline by the caller, which has no handle to continue with yet
+    void startInline(Result<T>* result) {
+        continuation_ = nullptr;
+        result_ = result;
+        up_slot_.installIfConnected(this);
+    }
+
+    // The body has suspended while running inline, the caller suspends too
+    void setContinuation(std::coroutine_handle<> caller) { continuation_ = caller; }
+
     void* operator new(size_t size) noexcept { return alloc::allocate(size, std::nothrow); }
     void operator delete(void* ptr, size_t size) { alloc::deallocate(ptr, size); }
     static auto get_return_object_on_allocation_failure() { return Async<T>{}; }
@@ -160,6 +265,18 @@ class AsyncPromiseBase : CancellationHandler {
         return down_sig_.emit();
     }
 
+    template <typename A>
+    auto transform(A&& awaitable, SuspendPoint point) {
+        if constexpr (CancellableAwaitable<A>) {
+            if (up_slot_.isConnected()) [[likely]] {
+                awaitable.setCancellationSlot(down_sig_.slot());
+            }
+        }
+
+        return Callee<get_awaiter_t<A>>(
+            cancelled(), std::forward<A>(awaitable).operator co_await(), point);
+    }
+
     bool cancelled() const { return result_->code() == ErrCode::Cancelled; }
 
     CancellationSlot up_slot_;
@@ -237,6 +354,15 @@ class [[nodiscard]] Async : supp::NonCopyable {
         return std::move(*this);
     }
 
+    // Starts the body right away, inside await_suspend() of the caller.
+    // A body completing without suspending resumes the caller straight from there,
+    // so trivial children cost no resume round-trip and long sequences of them keep
+    // the native stack flat. Nesting of inline bodies is limited by EXEC_EAGER_DEPTH.
+    auto eager() && {
+        // nullptr coroutine_ means OutOfMemory
+        return Eager{std::exchange(coroutine_, nullptr)};
+    }
+
     auto operator co_await() {
         struct Awaiter : supp::Pinned {
             Awaiter(std::coroutine_handle<promise_type> coroutine)
@@ -262,6 +388,7 @@ class [[nodiscard]] Async : supp::NonCopyable {
 
             std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller) {
                 coroutine_.promise().suspend(caller, &result_);
+                trace::record(trace::Event::FrameResume, &coroutine_.promise());
                 return std::exchange(coroutine_, nullptr);
             }
 
@@ -276,6 +403,83 @@ class [[nodiscard]] Async : supp::NonCopyable {
     }
 
  private:
+    struct EagerAwaiter : supp::Pinned {
+        EagerAwaiter(std::coroutine_handle<promise_type> coroutine)
+            : coroutine_{std::move(coroutine)} {}
+
+        ~EagerAwaiter() {
+            if (!coroutine_) {
+                return;
+            }
+
+            // the coroutine has been discarded
+            coroutine_.destroy();
+        }
+
+        bool await_ready() {
+            if (!coroutine_) {
+                result_.setError(ErrCode::OutOfMemory);
+                return true;
+            }
+
+            return false;
+        }
+
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller) {
+            auto& promise = coroutine_.promise();
+
+            if (detail::eagerDepth >= EXEC_EAGER_DEPTH) {
+                // too deep to start inline
+                promise.suspend(caller, &result_);
+                trace::record(trace::Event::FrameResume, &promise);
+                return std::exchange(coroutine_, nullptr);
+            }
+
+            promise.startInline(&result_);
+            trace::record(trace::Event::FrameResume, &promise);
+
+            ++detail::eagerDepth;
+            // the frame is gone or owned by the body from here on
+            std::exchange(coroutine_, nullptr).resume();
+            --detail::eagerDepth;
+
+            // children of the body running inline have consumed their completions already
+            if (std::exchange(detail::eagerCompleted, false)) {
+                return caller;
+            }
+
+            promise.setContinuation(caller);
+            return std::noop_coroutine();
+        }
+
+        Result<T> await_resume() { return std::move(result_); }
+
+        std::coroutine_handle<promise_type> coroutine_;
+        Result<T> result_;
+    };
+
+    struct [[nodiscard]] Eager : supp::NonCopyable {
+        Eager(std::coroutine_handle<promise_type> coroutine) : coroutine_{coroutine} {}
+        Eager(Eager&& r) noexcept : coroutine_(std::exchange(r.coroutine_, nullptr)) {}
+
+        ~Eager() {
+            if (coroutine_) {
+                coroutine_.destroy();
+            }
+        }
+
+        // CancellableAwaitable
+        Eager& setCancellationSlot(CancellationSlot slot) {
+            DASSERT(coroutine_, F("Async<T> has been consumed"));
+            coroutine_.promise().setCancellationSlot(slot);
+            return *this;
+        }
+
+        EagerAwaiter operator co_await() { return EagerAwaiter{std::exchange(coroutine_, nullptr)}; }
+
+        std::coroutine_handle<promise_type> coroutine_;
+    };
+
     std::coroutine_handle<promise_type> coroutine_ = nullptr;
 };
 
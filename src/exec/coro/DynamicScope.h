@@ -1,8 +1,10 @@
 #pragma once
 
+#include "exec/Error.h"
 #include "exec/Unit.h"
 #include "exec/coro/cancel.h"
 #include "exec/coro/traits.h"
+#include "exec/trace/trace.h"
 
 #include <supp/IntrusiveList.h>
 #include <supp/NonCopyable.h>
@@ -11,9 +13,14 @@
 #include <logging/log.h>
 
 #include <coroutine>
+#include <cstddef>
+#include <limits>
 
 namespace exec {
 
+// Starts tasks right away and joins them.
+// The number of tasks in flight may be limited: addWhenReady() suspends the producer until
+// there is room for another task.
 class DynamicScope {
     struct Promise : supp::IntrusiveListNode {
         using coroutine_handle_t = std::coroutine_handle<Promise>;
@@ -23,8 +30,12 @@ class DynamicScope {
             if constexpr (CancellableAwaitable<A>) {
                 awaitable.setCancellationSlot(sig.slot());
             }
+
+            trace::record(trace::Event::FrameCreate, this);
         }
 
+        ~Promise() { trace::record(trace::Event::FrameDestroy, this); }
+
         auto get_return_object() { return coroutine_handle_t::from_promise(*this); }
         auto initial_suspend() { return std::suspend_always{}; }
 
@@ -60,6 +71,7 @@ class DynamicScope {
 
         void start() {
             DASSERT(scope);
+            trace::record(trace::Event::FrameResume, this);
             handle().resume();
         }
 
@@ -131,24 +143,129 @@ class DynamicScope {
         CancellationSlot slot_;
     };
 
+    // Producer parked in addWhenReady()
+    struct Waiter : CancellationHandler, supp::IntrusiveListNode {
+        Waiter(DynamicScope* self, CancellationSlot slot) : self_{self}, slot_{slot} {}
+
+        // CancellationHandler
+        std::coroutine_handle<> cancel() override {
+            unlink();
+            self_ = nullptr;
+            return caller_;
+        }
+
+        // A slot has been reserved for the producer
+        std::coroutine_handle<> admit() {
+            slot_.clearIfConnected();
+            admitted_ = true;
+            return caller_;
+        }
+
+        DynamicScope* self_;
+        CancellationSlot slot_;
+        std::coroutine_handle<> caller_ = nullptr;
+        bool admitted_ = false;
+    };
+
+    template <Awaitable A>
+    struct AddAwaiter : Waiter {
+        AddAwaiter(DynamicScope* self, A&& awaitable, CancellationSlot slot)
+            : Waiter{self, slot}
+            , awaitable_{std::move(awaitable)} {}
+
+        bool await_ready() {
+            if (self_->full()) {
+                return false;
+            }
+
+            self_->add(std::move(awaitable_));
+            return true;
+        }
+
+        void await_suspend(std::coroutine_handle<> caller) {
+            caller_ = caller;
+            slot_.installIfConnected(this);
+            self_->waiters_.pushBack(this);
+        }
+
+        ErrCode await_resume() {
+            if (self_ == nullptr) {
+                return ErrCode::Cancelled;
+            }
+
+            if (admitted_) {
+                self_->start(std::move(awaitable_));
+            }
+
+            return ErrCode::Success;
+        }
+
+     private:
+        using Waiter::admitted_;
+        using Waiter::caller_;
+        using Waiter::self_;
+        using Waiter::slot_;
+
+        A awaitable_;
+    };
+
+    template <Awaitable A>
+    struct [[nodiscard]] AddWhenReady : supp::NonCopyable {
+        AddWhenReady(DynamicScope* self, A&& awaitable)
+            : self_{self}
+            , awaitable_{std::move(awaitable)} {}
+
+        // CancellableAwaitable
+        AddWhenReady& setCancellationSlot(CancellationSlot slot) {
+            slot_ = slot;
+            return *this;
+        }
+
+        auto operator co_await() { return AddAwaiter<A>{self_, std::move(awaitable_), slot_}; }
+
+     private:
+        DynamicScope* self_;
+        A awaitable_;
+        CancellationSlot slot_{};
+    };
+
  public:
     DynamicScope() = default;
+    explicit DynamicScope(size_t limit) : limit_{limit} {}
 
     ~DynamicScope() {
         DASSERT(caller_ == nullptr);
+        DASSERT(waiters_.empty(), "producers are waiting on a destroyed scope");
         tasks_.iterate([](Promise& task) { task.drop(); });
     }
 
     size_t size() const { return size_; }
+    size_t limit() const { return limit_; }
+    bool full() const { return size_ >= limit_; }
 
+    // Starts the task regardless of the limit.
     template <Awaitable A>
     void add(A&& awaitable) {
-        Task task = makeTask(std::forward<A>(awaitable), this);
-        tasks_.pushBack(task.promise());
         ++size_;
+        start(std::forward<A>(awaitable));
+    }
 
-        // Start the task immediately. This may trigger new tasks to be added.
-        task.promise()->start();
+    // Starts the task only if the limit is not reached.
+    template <Awaitable A>
+    [[nodiscard]] bool tryAdd(A&& awaitable) {
+        if (full()) {
+            return false;
+        }
+
+        add(std::forward<A>(awaitable));
+        return true;
+    }
+
+    // Suspends the caller until the number of tasks in flight drops below the limit,
+    // then starts the task. Cancelled caller discards the task.
+    template <Awaitable A>
+    CancellableAwaitable auto addWhenReady(A awaitable) {
+        return AddWhenReady<A>{this, std::move(awaitable)};
     }
 
     CancellableAwaitable auto join() {
@@ -173,9 +290,26 @@ class DynamicScope {
  private:
     bool joining() const { return caller_ != nullptr; }
 
+    // size_ must already account for the task.
+    template <Awaitable A>
+    void start(A&& awaitable) {
+        Task task = makeTask(std::forward<A>(awaitable), this);
+        tasks_.pushBack(task.promise());
+
+        // Start the task immediately. This may trigger new tasks to be added.
+        task.promise()->start();
+    }
+
     std::coroutine_handle<> arrived() {
         --size_;
 
+        if (!waiters_.empty() && !full()) {
+            // Reserve the freed slot for the first parked producer, it starts its task
+            // as soon as it is resumed.
+            ++size_;
+            return waiters_.popFront()->admit();
+        }
+
         if (size_ > 0 || caller_ == nullptr) {
             return std::noop_coroutine();
         }
@@ -184,7 +318,9 @@ class DynamicScope {
     }
 
     size_t size_ = 0;
+    size_t limit_ = std::numeric_limits<size_t>::max();
     supp::IntrusiveList<Promise> tasks_;
+    supp::IntrusiveList<Waiter> waiters_;
     std::coroutine_handle<> caller_ = nullptr;
 };
 
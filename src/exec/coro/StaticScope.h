@@ -0,0 +1,253 @@
+#pragma once
+
+#include "exec/Unit.h"
+#include "exec/coro/cancel.h"
+#include "exec/coro/traits.h"
+#include "exec/trace/trace.h"
+
+#include <supp/Pinned.h>
+
+#include <logging/log.h>
+
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+namespace exec {
+
+// Same as DynamicScope, but the frames the scope runs its tasks in are placed into
+// N preallocated slots of MaxFrameBytes each instead of the heap.
+// The awaitable itself is moved into the slot, frames of Async<T> children are still
+// allocated by the caller when they are created.
+// add() fails if all slots are busy or if the task's frame does not fit into a slot.
+template <size_t N, size_t MaxFrameBytes>
+class StaticScope : supp::Pinned {
+    struct Promise;
+    struct Task;
+
+    struct Slot {
+        alignas(std::max_align_t) uint8_t frame[MaxFrameBytes] /* uninitialized */;
+        Promise* task = nullptr;
+    };
+
+    struct Promise {
+        using coroutine_handle_t = std::coroutine_handle<Promise>;
+
+        template <Awaitable A>
+        Promise(A&& awaitable, StaticScope* scope, Slot* slot) : scope{scope}, slot{slot} {
+            if constexpr (CancellableAwaitable<A>) {
+                awaitable.setCancellationSlot(sig.slot());
+            }
+
+            trace::record(trace::Event::FrameCreate, this);
+        }
+
+        ~Promise() { trace::record(trace::Event::FrameDestroy, this); }
+
+        // The frame is placed into the slot. The slot is released by the scope.
+        void* operator new(size_t size, auto&& /*awaitable*/, StaticScope*, Slot* slot) noexcept {
+            return size <= MaxFrameBytes ? slot->frame : nullptr;
+        }
+
+        void operator delete(void*, size_t) {}
+        static Task get_return_object_on_allocation_failure() { return Task{nullptr}; }
+
+        auto get_return_object() { return coroutine_handle_t::from_promise(*this); }
+        auto initial_suspend() { return std::suspend_always{}; }
+
+        void unhandled_exception() {
+            LFATAL("unhandled exception in StaticScope task");
+            abort();
+        }
+
+        auto final_suspend() noexcept {
+            struct Awaitable {
+                bool await_ready() noexcept { return false; }
+                void await_resume() noexcept {}
+
+                std::coroutine_handle<> await_suspend(coroutine_handle_t self) noexcept {
+                    Promise& promise = self.promise();
+                    StaticScope* scope = promise.scope;
+                    DASSERT(scope, "dropped task has finished");
+
+                    promise.slot->task = nullptr;
+                    self.destroy();
+                    return scope->arrived();
+                }
+            };
+
+            return Awaitable{};
+        }
+
+        template <typename T>
+        void return_value(T&& value) {
+            (void)value;
+        }
+
+        void start() {
+            DASSERT(scope);
+            trace::record(trace::Event::FrameResume, this);
+            handle().resume();
+        }
+
+        void drop() {
+            DASSERT(scope);
+            scope = nullptr;
+            slot->task = nullptr;
+            handle().destroy();
+        }
+
+        std::coroutine_handle<> cancel() { return sig.emit(); }
+        coroutine_handle_t handle() { return coroutine_handle_t::from_promise(*this); }
+
+        StaticScope* scope;
+        Slot* slot;
+        CancellationSignal sig{};
+    };
+
+    struct Task {
+        using promise_type = Promise;
+        using coroutine_handle_t = std::coroutine_handle<promise_type>;
+        Task(coroutine_handle_t coro) : coro_{coro} {}
+        Task(Task&& r) noexcept : coro_{std::exchange(r.coro_, nullptr)} {}
+        Promise* promise() { return coro_ ? &coro_.promise() : nullptr; }
+        coroutine_handle_t coro_;
+    };
+
+    template <Awaitable A>
+    static Task makeTask(A&& awaitable, StaticScope* /*self*/, Slot* /*slot*/) {
+        // self and slot are passed to Promise's constructor and operator new.
+        // The awaitable is taken over only once the frame has been placed into the slot.
+        std::remove_cvref_t<A> task = std::forward<A>(awaitable);
+        co_return co_await std::move(task);
+    }
+
+    struct JoinAwaiter : CancellationHandler {
+        JoinAwaiter(StaticScope* self, CancellationSlot slot) : self_{self}, slot_{slot} {}
+
+        bool await_ready() const { return self_->size() == 0; }
+
+        Unit await_resume() {
+            slot_.clearIfConnected();
+            return unit;
+        }
+
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller) {
+            if (self_->size_ == 0) {
+                return caller;
+            }
+
+            self_->caller_ = caller;
+            slot_.installIfConnected(this);
+            return std::noop_coroutine();
+        }
+
+     private:
+        std::coroutine_handle<> cancel() override {
+            DASSERT(self_->caller_ != nullptr);
+
+            auto a_caller = std::exchange(self_->caller_, nullptr);
+            for (auto& slot : self_->slots_) {
+                if (slot.task != nullptr) {
+                    slot.task->cancel().resume();
+                }
+            }
+
+            if (self_->size_ == 0) {
+                return a_caller;
+            }
+
+            self_->caller_ = a_caller;
+            return std::noop_coroutine();
+        }
+
+        StaticScope* self_;
+        CancellationSlot slot_;
+    };
+
+ public:
+    StaticScope() = default;
+
+    ~StaticScope() {
+        DASSERT(caller_ == nullptr);
+
+        for (auto& slot : slots_) {
+            if (slot.task != nullptr) {
+                slot.task->drop();
+            }
+        }
+    }
+
+    size_t size() const { return size_; }
+    static constexpr size_t capacity() { return N; }
+
+    // Returns false if there is no free slot or the task's frame does not fit into one,
+    // the awaitable is left to the caller then.
+    template <Awaitable A>
+    [[nodiscard]] bool add(A&& awaitable) {
+        Slot* slot = freeSlot();
+        if (slot == nullptr) {
+            return false;
+        }
+
+        Task task = makeTask(std::forward<A>(awaitable), this, slot);
+        if (task.promise() == nullptr) {
+            return false;
+        }
+
+        slot->task = task.promise();
+        ++size_;
+
+        // Start the task immediately. This may trigger new tasks to be added.
+        slot->task->start();
+        return true;
+    }
+
+    CancellableAwaitable auto join() {
+        struct Awaitable {
+            Awaitable(StaticScope* self) : self_{self} {}
+            auto operator co_await() { return JoinAwaiter{self_, slot_}; }
+
+            // CancellableAwaitable
+            Awaitable& setCancellationSlot(CancellationSlot slot) {
+                slot_ = slot;
+                return *this;
+            }
+
+         private:
+            StaticScope* self_;
+            CancellationSlot slot_;
+        };
+
+        return Awaitable{this};
+    }
+
+ private:
+    Slot* freeSlot() {
+        for (auto& slot : slots_) {
+            if (slot.task == nullptr) {
+                return &slot;
+            }
+        }
+
+        return nullptr;
+    }
+
+    std::coroutine_handle<> arrived() {
+        --size_;
+
+        if (size_ > 0 || caller_ == nullptr) {
+            return std::noop_coroutine();
+        }
+
+        return std::exchange(caller_, nullptr);
+    }
+
+    Slot slots_[N];
+    size_t size_ = 0;
+    std::coroutine_handle<> caller_ = nullptr;
+};
+
+}  // namespace exec
@@ -0,0 +1,216 @@
+#pragma once
+
+#include "exec/Unit.h"
+#include "exec/coro/Async.h"
+#include "exec/coro/alloc.h"
+#include "exec/coro/traits.h"
+#include "exec/result/Result.h"
+#include "exec/trace/trace.h"
+
+#include <supp/NonCopyable.h>
+#include <supp/Pinned.h>
+#include <supp/verify.h>
+
+#include <logging/log.h>
+
+#include <coroutine>
+#include <cstdlib>
+#include <utility>
+
+namespace exec {
+
+template <typename T>
+class Task;
+
+namespace detail {
+
+template <typename T>
+class TaskPromiseBase {
+    struct FinalAwaitable {
+        constexpr bool await_ready() const noexcept { return false; }
+
+        template <typename P>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<P> self) noexcept {
+            auto continuation = self.promise().continuation_;
+            self.destroy();
+            return continuation;
+        }
+
+        void await_resume() noexcept {}
+    };
+
+#if EXEC_TRACE || EXEC_AWAIT_PROFILE
+    template <typename A>
+    struct Callee {
+        bool await_ready() { return impl.await_ready(); }
+
+        template <typename P>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<P> self_p) {
+            point.suspended(&self_p.promise());
+
+            if constexpr (std::same_as<void, decltype(impl.await_suspend(self_p))>) {
+                impl.await_suspend(self_p);
+                return std::noop_coroutine();
+            } else if constexpr (std::same_as<bool, decltype(impl.await_suspend(self_p))>) {
+                return impl.await_suspend(self_p) ? std::noop_coroutine() : self_p;
+            } else {
+                return impl.await_suspend(self_p);
+            }
+        }
+
+        decltype(auto) await_resume() {
+            point.resumed();
+            return std::move(impl).await_resume();
+        }
+
+        A impl;
+        SuspendPoint point;
+    };
+#endif
+
+ public:
+    TaskPromiseBase() { trace::record(trace::Event::FrameCreate, this); }
+    ~TaskPromiseBase() { trace::record(trace::Event::FrameDestroy, this); }
+
+    auto initial_suspend() { return std::suspend_always{}; }
+    auto final_suspend() noexcept { return FinalAwaitable{}; }
+
+    void unhandled_exception() {
+        LFATAL("unhandled exception in Task body");
+        abort();
+    }
+
+    // Awaitables are awaited as they are, unless the tracer or the await profiler needs to
+    // see the suspension
+#if EXEC_AWAIT_PROFILE
+    template <typename A>
+    auto await_transform(A&& awaitable, std::source_location loc = std::source_location::current()) {
+        return Callee<get_awaiter_t<A>>{std::forward<A>(awaitable).operator co_await(),
+            SuspendPoint{loc}};
+    }
+#elif EXEC_TRACE
+    template <typename A>
+    auto await_transform(A&& awaitable) {
+        return Callee<get_awaiter_t<A>>{std::forward<A>(awaitable).operator co_await(),
+            SuspendPoint{}};
+    }
+#endif
+
+    void suspend(std::coroutine_handle<> caller, Result<T>* result) {
+        continuation_ = caller;
+        result_ = result;
+    }
+
+    void* operator new(size_t size) noexcept { return alloc::allocate(size, std::nothrow); }
+    void operator delete(void* ptr, size_t size) { alloc::deallocate(ptr, size); }
+    static auto get_return_object_on_allocation_failure() { return Task<T>{}; }
+
+ protected:
+    Result<T>* result_ = nullptr;
+
+ private:
+    std::coroutine_handle<> continuation_ = std::noop_coroutine();
+};
+
+template <typename T>
+class TaskPromise : public TaskPromiseBase<T> {
+ public:
+    auto get_return_object() {  // NOLINT
+        return std::coroutine_handle<TaskPromise>::from_promise(*this);
+    }
+
+    template <typename U>
+    void return_value(U&& value) {
+        DASSERT(this->result_);
+        this->result_->emplace(std::forward<U>(value));
+    }
+
+    void return_value(Result<T> value) {
+        DASSERT(this->result_);
+        *this->result_ = std::move(value);
+    }
+};
+
+template <>
+class TaskPromise<Unit> : public TaskPromiseBase<Unit> {
+ public:
+    auto get_return_object() { return std::coroutine_handle<TaskPromise>::from_promise(*this); }
+
+    void return_void() {
+        DASSERT(this->result_);
+        this->result_->emplace(unit);
+    }
+};
+
+}  // namespace detail
+
+// Async<T> without cancellation: the frame has no cancellation state and co_await inside
+// a Task transfers control directly to the awaited coroutine.
+// Awaitables are awaited without a cancellation slot, so a Task runs to completion.
+// Use for leaf coroutines that are never cancelled on their own.
+template <typename T = Unit>
+class [[nodiscard]] Task : supp::NonCopyable {
+ public:
+    using promise_type = detail::TaskPromise<T>;
+    using value_type = Result<T>;
+
+    Task() = default;
+    Task(std::coroutine_handle<promise_type> coroutine) : coroutine_(coroutine) {}
+    Task(Task&& r) noexcept : coroutine_(std::exchange(r.coroutine_, nullptr)) {}
+
+    ~Task() {
+        if (!coroutine_) {
+            return;
+        }
+
+        // Task<T> has not been consumed
+        coroutine_.destroy();
+    }
+
+    auto operator co_await() {
+        struct Awaiter : supp::Pinned {
+            Awaiter(std::coroutine_handle<promise_type> coroutine)
+                : coroutine_{std::move(coroutine)} {}
+
+            ~Awaiter() {
+                if (!coroutine_) {
+                    return;
+                }
+
+                // the coroutine has been discarded
+                coroutine_.destroy();
+            }
+
+            bool await_ready() {
+                if (!coroutine_) {
+                    result_.setError(ErrCode::OutOfMemory);
+                    return true;
+                }
+
+                return false;
+            }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller) {
+                coroutine_.promise().suspend(caller, &result_);
+                trace::record(trace::Event::FrameResume, &coroutine_.promise());
+                return std::exchange(coroutine_, nullptr);
+            }
+
+            Result<T> await_resume() { return std::move(result_); }
+
+            std::coroutine_handle<promise_type> coroutine_;
+            Result<T> result_;
+        };
+
+        // nullptr coroutine_ means OutOfMemory
+        return Awaiter{std::exchange(coroutine_, nullptr)};
+    }
+
+ private:
+    std::coroutine_handle<promise_type> coroutine_ = nullptr;
+};
+
+template <typename T>
+class Task<Result<T>> {};
+
+}  // namespace exec
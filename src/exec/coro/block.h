@@ -0,0 +1,147 @@
+#pragma once
+
+#include "exec/Error.h"
+#include "exec/result/Result.h"
+#include "exec/coro/cancel.h"
+#include "exec/coro/traits.h"
+#include "exec/os/OS.h"
+
+#include <supp/ManualLifetime.h>
+#include <supp/NonCopyable.h>
+
+#include <logging/log.h>
+#include <time/config.h>
+#include <time/mono.h>
+
+#include <coroutine>
+#include <utility>
+
+#if !TIME_MANUAL && !defined(ARDUINO)
+#include <chrono>
+#include <thread>
+#endif
+
+namespace exec {
+
+namespace detail {
+
+template <typename T>
+struct BlockOnTask : supp::NonCopyable {
+    struct promise_type {
+        template <Awaitable A>
+        promise_type(A&& awaitable, CancellationSignal* sig) {
+            if constexpr (CancellableAwaitable<A>) {
+                awaitable.setCancellationSlot(sig->slot());
+            }
+        }
+
+        auto get_return_object() {
+            return BlockOnTask{std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+
+        auto initial_suspend() const { return std::suspend_always{}; }
+
+        // The frame is destroyed by BlockOnTask
+        auto final_suspend() const noexcept { return std::suspend_always{}; }
+
+        template <typename U>
+        void return_value(U&& value) {
+            result.emplace(std::forward<U>(value));
+        }
+
+        void unhandled_exception() const {
+            LFATAL("unhandled exception in blockOn task");
+            abort();
+        }
+
+        supp::ManualLifetime<T> result;
+    };
+
+    BlockOnTask(std::coroutine_handle<promise_type> h) : coro{h} {}
+    BlockOnTask(BlockOnTask&& rhs) noexcept : coro{std::exchange(rhs.coro, nullptr)} {}
+
+    ~BlockOnTask() {
+        if (!coro) {
+            return;
+        }
+
+        // a suspended frame would keep references into blockOn()'s stack
+        DASSERT(coro.done(), F("blockOn task destroyed before completion"));
+        coro.destroy();
+    }
+
+    std::coroutine_handle<promise_type> coro;
+};
+
+template <Awaitable A>
+BlockOnTask<awaitable_result_t<A>> makeBlockOnTask(A task, CancellationSignal* /*sig*/) {
+    // sig is passed to the promise_type's constructor
+    co_return co_await std::move(task);
+}
+
+// Waits until the given time comes.
+// With manual time the clock jumps straight to it, so simulations do not wait for real.
+inline void sleepUntil(ttime::Time at) {
+    auto now = ttime::mono::now();
+    if (now >= at) {
+        return;
+    }
+
+#if TIME_MANUAL
+    ttime::mono::set(at);
+#elif defined(ARDUINO)
+    // nothing to sleep on, keep ticking
+#else
+    std::this_thread::sleep_for(std::chrono::milliseconds(at.millis() - now.millis()));
+#endif
+}
+
+}  // namespace detail
+
+// Drives os.tick() until the awaitable completes, sleeping until os.wakeAt() in between.
+//
+// If the awaitable has not completed and no service has pending work, it can never complete:
+// it is cancelled and ErrCode::Deadlock is returned. An awaitable that does not complete
+// once cancelled is fatal.
+// Wakeups from outside of the OS (e.g. interrupts) are not visible to the driver.
+template <Awaitable A>
+Result<result_type_t<awaitable_result_t<A>>> blockOn(OS& os, A awaitable) {
+    using ResultType = Result<result_type_t<awaitable_result_t<A>>>;
+
+    CancellationSignal sig;
+    auto task = detail::makeBlockOnTask(std::move(awaitable), &sig);
+    task.coro.resume();
+
+    while (!task.coro.done()) {
+        os.tick();
+        if (task.coro.done()) {
+            break;
+        }
+
+        auto wake_at = os.wakeAt();
+        if (wake_at >= ttime::Time::max()) {
+            sig.emitSync();
+
+            // cancelled operations may need a few ticks to unwind
+            while (!task.coro.done() && os.wakeAt() < ttime::Time::max()) {
+                detail::sleepUntil(os.wakeAt());
+                os.tick();
+            }
+
+            if (!task.coro.done()) {
+                LFATAL("blockOn task is stuck in a non-cancellable operation");
+                abort();
+            }
+
+            return ResultType{ErrCode::Deadlock};
+        }
+
+        detail::sleepUntil(wake_at);
+    }
+
+    // not a direct-initialization: an ErrCode value must not turn into an error
+    ResultType result = std::move(task.coro.promise().result).get();
+    return result;
+}
+
+}  // namespace exec
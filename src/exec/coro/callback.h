@@ -17,10 +17,10 @@ concept CallbackService = requires(S& service, typename S::CallbackType* callbac
     { service.setCallback(callback) } -> std::same_as<void>;
 };
 
-// TODO: add tests?
-// This is WIP
+// Waits for the next callback from the service.
+// Cancellation resets the service callback and resumes the caller inline.
 template <CallbackService Service>
-Awaitable auto waitCallback(Service& service) {
+CancellableAwaitable auto waitCallback(Service& service) {
     using CallbackType = typename Service::CallbackType;
     using ResultType = Result<typename Service::CallbackArgType>;
 
@@ -45,6 +45,7 @@ Awaitable auto waitCallback(Service& service) {
         // CancellationHandler
         std::coroutine_handle<> cancel() override {
             DASSERT(caller_ != nullptr);
+            service_.setCallback(nullptr);
             result_.setError(ErrCode::Cancelled);
             return caller_;
         }
@@ -63,6 +64,12 @@ Awaitable auto waitCallback(Service& service) {
     };
 
     struct Awaitable {
+        // CancellableAwaitable
+        Awaitable& setCancellationSlot(CancellationSlot slot) {
+            this->slot = slot;
+            return *this;
+        }
+
         Awaiter operator co_await() { return Awaiter(service, slot); }
 
         Service& service;
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <supp/IntrusiveList.h>
 #include <supp/Pinned.h>
 #include <supp/verify.h>
 
@@ -72,4 +73,76 @@ class CancellationSignal : supp::Pinned {
     CancellationHandler* handler_ = nullptr;
 };
 
+class CancellationSource;
+
+// One operation subscribed to a CancellationSource.
+// Can be embedded in an awaiter or a coroutine frame, connecting and disconnecting are O(1).
+class CancellationRegistration : public supp::IntrusiveListNode, supp::Pinned {
+ public:
+    CancellationRegistration() = default;
+    ~CancellationRegistration() { disconnect(); }
+
+    // Subscribes to source, start the operation with the returned slot
+    inline CancellationSlot connect(CancellationSource& source);
+
+    void disconnect() {
+        if (source_ != nullptr) {
+            unlink();
+            source_ = nullptr;
+        }
+    }
+
+    bool isConnected() const { return source_ != nullptr; }
+
+ private:
+    CancellationSource* source_ = nullptr;
+    CancellationSignal sig_;
+
+    friend class CancellationSource;
+};
+
+// Fans a single cancellation request out to every connected registration.
+// Operations connected after requestCancel() are not cancelled by it, check cancelRequested()
+// before starting them.
+class CancellationSource : supp::Pinned {
+ public:
+    CancellationSource() = default;
+
+    ~CancellationSource() {
+        while (!registrations_.empty()) {
+            registrations_.popFront()->source_ = nullptr;
+        }
+    }
+
+    void requestCancel() {
+        requested_ = true;
+
+        // cancelled operations may disconnect others or connect again while being resumed
+        auto registrations(std::move(registrations_));
+
+        while (!registrations.empty()) {
+            auto* reg = registrations.popFront();
+            reg->source_ = nullptr;
+            reg->sig_.emitSync();
+        }
+    }
+
+    bool cancelRequested() const { return requested_; }
+    bool hasRegistrations() const { return !registrations_.empty(); }
+
+ private:
+    supp::IntrusiveList<CancellationRegistration> registrations_;
+    bool requested_ = false;
+
+    friend class CancellationRegistration;
+};
+
+CancellationSlot CancellationRegistration::connect(CancellationSource& source) {
+    DASSERT(source_ == nullptr, F("registration connected twice"));
+
+    source_ = &source;
+    source.registrations_.pushBack(this);
+    return sig_.slot();
+}
+
 }  // namespace exec
@@ -1,20 +1,20 @@
 #pragma once
 
 #include "exec/Error.h"
+#include "exec/coro/cancel.h"
 #include "exec/coro/traits.h"
 #include "exec/os/DeferService.h"
 
-#include <supp/Pinned.h>
 #include <time/mono.h>
 
 #include <coroutine>
 
 namespace exec {
 
-// Not cancellable
-inline Awaitable auto defer(ttime::Duration d) {
-    struct [[nodiscard]] Awaiter : Runnable, supp::Pinned {
-        Awaiter(ttime::Duration d) : d{d} {}
+// Cancellable, the cancelled entry is removed from the DeferService right away
+inline CancellableAwaitable auto defer(ttime::Duration d) {
+    struct [[nodiscard]] Awaiter : DeferEntry, CancellationHandler {
+        Awaiter(ttime::Duration d, CancellationSlot slot) : d{d}, slot_{slot} {}
 
         bool await_ready() {
             if (d.millis() == 0) {
@@ -31,6 +31,7 @@ inline Awaitable auto defer(ttime::Duration d) {
                 return caller;
             }
 
+            slot_.installIfConnected(this);
             this->caller = caller;
             return std::noop_coroutine();
         }
@@ -41,18 +42,38 @@ inline Awaitable auto defer(ttime::Duration d) {
         }
 
         void run() override {
+            slot_.clearIfConnected();
             code_ = ErrCode::Success;
             caller.resume();
         }
 
+        // CancellationHandler
+        std::coroutine_handle<> cancel() override {
+            if (!service<DeferService>()->cancel(this)) {
+                return std::noop_coroutine();
+            }
+
+            code_ = ErrCode::Cancelled;
+            return caller;
+        }
+
         const ttime::Duration d;
+        CancellationSlot slot_;
         std::coroutine_handle<> caller;
         ErrCode code_ = ErrCode::Unknown;
     };
 
     struct Awaitable {
-        auto operator co_await() { return Awaiter{d}; }
+        // CancellableAwaitable
+        Awaitable& setCancellationSlot(CancellationSlot slot) {
+            this->slot = slot;
+            return *this;
+        }
+
+        auto operator co_await() { return Awaiter{d, slot}; }
+
         const ttime::Duration d;
+        CancellationSlot slot{};
     };
 
     return Awaitable{d};
@@ -0,0 +1,365 @@
+#pragma once
+
+#include "exec/Error.h"
+#include "exec/Unit.h"
+#include "exec/config.h"
+#include "exec/result/Result.h"
+#include "exec/coro/cancel.h"
+#include "exec/coro/traits.h"
+
+#include <supp/NonCopyable.h>
+#include <supp/Pinned.h>
+
+#include <array>
+#include <concepts>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <tuple>
+#include <utility>
+#include <variant>
+
+namespace exec {
+
+namespace detail {
+
+template <size_t Branches>
+class SelectState;
+
+// Resumption point of a single branch.
+// Its frame is placed into the select awaiter, so nothing is allocated.
+template <size_t Branches>
+struct SelectResumer : supp::NonCopyable {
+    using State = SelectState<Branches>;
+
+    struct promise_type {
+        promise_type(State* state, uint8_t index) : state{state}, index{index} {}
+
+        static void* operator new(size_t size, State* state, uint8_t index) noexcept {
+            return state->frame(index, size);
+        }
+
+        static void operator delete(void* /*ptr*/) {}
+
+        static SelectResumer get_return_object_on_allocation_failure() {
+            return SelectResumer{nullptr};
+        }
+
+        auto get_return_object() {
+            return SelectResumer{std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+
+        auto initial_suspend() const { return std::suspend_always{}; }
+
+        auto final_suspend() const noexcept {
+            struct FinalAwaiter {
+                bool await_ready() noexcept { return false; }
+
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<> /*self*/) noexcept {
+                    return state->arrived(index);
+                }
+
+                void await_resume() noexcept {}
+
+                State* state;
+                uint8_t index;
+            };
+
+            return FinalAwaiter{state, index};
+        }
+
+        void return_void() {}
+
+        void unhandled_exception() {
+            LFATAL("unhandled exception in SelectResumer");
+            abort();
+        }
+
+        State* state;
+        uint8_t index;
+    };
+
+    SelectResumer() = default;
+    SelectResumer(std::coroutine_handle<> h) : coro{h} {}
+    SelectResumer(SelectResumer&& rhs) noexcept : coro{std::exchange(rhs.coro, nullptr)} {}
+
+    SelectResumer& operator=(SelectResumer&& rhs) noexcept {
+        std::swap(coro, rhs.coro);
+        return *this;
+    }
+
+    ~SelectResumer() {
+        if (coro) {
+            coro.destroy();
+        }
+    }
+
+    std::coroutine_handle<> coro = nullptr;
+};
+
+template <size_t Branches>
+SelectResumer<Branches> makeSelectResumer(SelectState<Branches>* /*state*/, uint8_t /*index*/) {
+    // state and index go to promise_type's constructor
+    co_return;
+}
+
+// Decides which branch wins and waits until all the others are cancelled.
+template <size_t Branches>
+class SelectState : public CancellationHandler {
+ public:
+    static_assert(Branches > 0 && Branches < UINT8_MAX);
+
+    static constexpr uint8_t None = UINT8_MAX;
+
+    // A resumer frame holds the resume and destroy pointers, the promise and the copies of
+    // the parameters the promise is made of. The layout is up to the compiler and its size is
+    // not known before the frame is allocated, EXEC_SELECT_FRAME_SLACK covers the rest.
+    static constexpr size_t FrameBytes = 2 * sizeof(void (*)())
+        + 2 * sizeof(typename SelectResumer<Branches>::promise_type) + EXEC_SELECT_FRAME_SLACK;
+
+    explicit SelectState(CancellationSlot slot) : slot_{slot} {}
+
+    void* frame(uint8_t index, size_t size) {
+        DASSERT(size <= FrameBytes,
+            F("select() resumer frame too large, raise EXEC_SELECT_FRAME_SLACK"));
+        return size <= FrameBytes ? frames_[index].bytes : nullptr;
+    }
+
+    std::coroutine_handle<> arrived(uint8_t index) {
+        --pending_;
+
+        if (!cancelled_[index] && winner_ == None) {
+            winner_ = index;
+            cancelParked();
+        }
+
+        // a branch completing after another one has won carries no value, see Selectable
+        return !busy_ && pending_ == 0 ? complete() : std::noop_coroutine();
+    }
+
+    // CancellationHandler
+    std::coroutine_handle<> cancel() override {
+        cancelParked();
+        return pending_ == 0 ? complete() : std::noop_coroutine();
+    }
+
+ protected:
+    CancellationSlot branchSlot(size_t index) { return signals_[index].slot(); }
+
+    void suspending(std::coroutine_handle<> caller) {
+        caller_ = caller;
+        busy_ = true;
+    }
+
+    // Returns the resumption handle to pass to the branch's awaiter or nullptr.
+    std::coroutine_handle<> park(uint8_t index) {
+        resumers_[index] = makeSelectResumer(this, index);
+        if (resumers_[index].coro == nullptr) {
+            failed_ = true;
+            cancelParked();
+            return nullptr;
+        }
+
+        ++pending_;
+        return resumers_[index].coro;
+    }
+
+    bool decided() const { return winner_ != None || failed_; }
+
+    std::coroutine_handle<> suspended() {
+        busy_ = false;
+
+        if (pending_ == 0) {
+            return std::exchange(caller_, nullptr);
+        }
+
+        slot_.installIfConnected(this);
+        return std::noop_coroutine();
+    }
+
+    uint8_t winner_ = None;
+    bool failed_ = false;
+
+ private:
+    // Parked branches are resumed synchronously by their cancellation
+    void cancelParked() {
+        const bool busy = std::exchange(busy_, true);
+
+        for (uint8_t i = 0; i < Branches; ++i) {
+            // marked before emitting: a branch may arrive through a handle other than its
+            // resumer (e.g. an Async's frame), synchronously or later
+            if (signals_[i].hasHandler()) {
+                cancelled_[i] = true;
+            }
+            signals_[i].emit().resume();
+        }
+
+        busy_ = busy;
+    }
+
+    std::coroutine_handle<> complete() {
+        slot_.clearIfConnected();
+        return std::exchange(caller_, nullptr);
+    }
+
+    struct Frame {
+        alignas(std::max_align_t) uint8_t bytes[FrameBytes];
+    };
+
+    CancellationSlot slot_;
+    std::coroutine_handle<> caller_ = nullptr;
+    uint8_t pending_ = 0;
+    bool busy_ = false;
+
+    std::array<CancellationSignal, Branches> signals_;
+    std::array<bool, Branches> cancelled_{};
+    std::array<Frame, Branches> frames_;
+    std::array<SelectResumer<Branches>, Branches> resumers_;  // placed in frames_
+};
+
+template <typename R>
+concept ValueLess = std::same_as<R, Unit> || std::same_as<R, Status> || std::same_as<R, ErrCode>;
+
+template <size_t I, typename A>
+struct SelectBranch {
+    SelectBranch(A& awaitable, CancellationSlot slot)
+        : awaiter(awaitable.setCancellationSlot(slot).operator co_await()) {}
+
+    get_awaiter_t<A> awaiter;
+};
+
+template <typename Indices, CancellableAwaitable... As>
+class Select;
+
+template <size_t... Is, CancellableAwaitable... As>
+class [[nodiscard]] Select<std::index_sequence<Is...>, As...> : supp::NonCopyable {
+    struct Awaiter;
+
+ public:
+    // The index of the alternative is the index of the branch that has won
+    using ResultType = std::variant<awaitable_result_t<As>...>;
+
+    Select(As... branches) : branches_(std::move(branches)...) {}
+    Select(Select&&) = default;
+
+    // CancellableAwaitable
+    Select& setCancellationSlot(CancellationSlot slot) {
+        slot_ = slot;
+        return *this;
+    }
+
+    Awaiter operator co_await() { return Awaiter{branches_, slot_}; }
+
+ private:
+    using State = SelectState<sizeof...(As)>;
+
+    struct Awaiter : State, SelectBranch<Is, As>... {
+        Awaiter(std::tuple<As...>& branches, CancellationSlot slot)
+            : State(slot)
+            , SelectBranch<Is, As>(std::get<Is>(branches), this->branchSlot(Is))... {}
+
+        // The first ready branch wins, the following ones are not even polled
+        bool await_ready() { return (... || ready<Is>()); }
+
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller) {
+            this->suspending(caller);
+            (void)(... && park<Is>());
+            return this->suspended();
+        }
+
+        Result<ResultType> await_resume() {
+            if (this->failed_) {
+                return err<ResultType>(ErrCode::OutOfMemory);
+            }
+
+            if (this->winner_ == State::None) {
+                return err<ResultType>(ErrCode::Cancelled);
+            }
+
+            Result<ResultType> res;
+            (void)(... || take<Is>(res));
+            return res;
+        }
+
+     private:
+        template <size_t I>
+        auto& awaiter() {
+            using Branch = SelectBranch<I, std::tuple_element_t<I, std::tuple<As...>>>;
+            return static_cast<Branch&>(*this).awaiter;
+        }
+
+        template <size_t I>
+        bool ready() {
+            if (!awaiter<I>().await_ready()) {
+                return false;
+            }
+
+            this->winner_ = I;
+            return true;
+        }
+
+        // Returns false once the select is decided and no more branches should be parked
+        template <size_t I>
+        bool park() {
+            auto resumer = State::park(I);
+            if (resumer == nullptr) {
+                return false;
+            }
+
+            auto& a = awaiter<I>();
+            using R = decltype(a.await_suspend(resumer));
+
+            if constexpr (std::same_as<R, void>) {
+                a.await_suspend(resumer);
+            } else if constexpr (std::same_as<R, bool>) {
+                if (!a.await_suspend(resumer)) {
+                    resumer.resume();
+                }
+            } else {
+                a.await_suspend(resumer).resume();
+            }
+
+            return !this->decided();
+        }
+
+        template <size_t I>
+        bool take(Result<ResultType>& res) {
+            if (this->winner_ != I) {
+                return false;
+            }
+
+            res.emplace(ResultType(std::in_place_index<I>, awaiter<I>().await_resume()));
+            return true;
+        }
+    };
+
+    std::tuple<As...> branches_;
+    CancellationSlot slot_{};
+};
+
+}  // namespace detail
+
+// An awaitable that can lose a select() without anything getting lost: its result carries no
+// value, or it hands its value over while resuming the waiter and declares
+// `static constexpr bool HandsOverInline = true`. The first branch to take a value is then
+// the first one to arrive, and the others are cancelled before they can take one.
+// Awaitables completing through an executor (scheduleOn(), IsrChannel, Async<T>) and bulk
+// operations polled in await_ready() (receiveMany()) do not qualify.
+template <typename A>
+concept Selectable = CancellableAwaitable<A>
+    && (detail::ValueLess<awaitable_result_t<A>> || A::HandsOverInline);
+
+// Waits for the first of the branches to complete and cancels all the others.
+// Branches park directly on their primitives: exactly one of them takes a value,
+// the others are cancelled without consuming anything. No frames are allocated.
+//
+// Returns the winning branch's index and value as a variant,
+// ErrCode::Cancelled if cancelled before any branch has completed.
+// Branches must wait on different primitives.
+template <Selectable... As>
+CancellableAwaitable auto select(As... branches) {
+    return detail::Select<std::index_sequence_for<As...>, As...>(std::move(branches)...);
+}
+
+}  // namespace exec
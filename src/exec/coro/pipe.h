@@ -0,0 +1,191 @@
+#pragma once
+
+#include "exec/coro/Async.h"
+#include "exec/coro/cancel.h"
+#include "exec/coro/traits.h"
+#include "exec/result/combine.h"
+
+#include <supp/NonCopyable.h>
+#include <supp/Pinned.h>
+
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace exec {
+
+namespace pipe {
+
+template <typename F>
+struct [[nodiscard]] AsyncAndThen : detail::Stage<AsyncAndThen<F>> {
+    static constexpr bool IsAsync = true;
+
+    F user;
+
+    explicit AsyncAndThen(F u) : user(std::move(u)) {}
+
+    template <typename T>
+    using Awaitable = std::invoke_result_t<F&, T&&>;
+
+    template <typename T>
+    using Out = traits::ValueOf<awaitable_result_t<Awaitable<T>>>;
+};
+
+namespace detail {
+
+// Value type before stage I
+template <size_t I, typename T, typename... Stages>
+struct PipeAt {
+    using type = T;
+};
+
+template <size_t I, typename T, typename S, typename... Rest>
+    requires(I > 0)
+struct PipeAt<I, T, S, Rest...> : PipeAt<I - 1, typename S::template Out<T>, Rest...> {};
+
+// Calls the user with the value and waits for the returned awaitable in place.
+// The user is called from await_ready() so that a cancelled frame skips it.
+template <typename F, typename In, typename Out>
+class AsyncStepAwaiter : supp::Pinned {
+    using A = typename AsyncAndThen<F>::template Awaitable<In>;
+    using Inner = get_awaiter_t<A>;
+
+ public:
+    AsyncStepAwaiter(AsyncAndThen<F>& stage, Result<In>* in, Result<Out>* out, CancellationSlot slot)
+        : stage_{&stage}, in_{in}, out_{out}, slot_{slot} {}
+
+    ~AsyncStepAwaiter() {
+        if (started_) {
+            inner().~Inner();
+        }
+    }
+
+    bool await_ready() {
+        if (!in_->hasValue()) {
+            out_->setError(in_->code());
+            return true;
+        }
+
+        A awaitable = std::invoke(stage_->user, static_cast<In&&>(**in_));
+        if constexpr (CancellableAwaitable<A>) {
+            awaitable.setCancellationSlot(slot_);
+        }
+
+        new (inner_) Inner(std::move(awaitable).operator co_await());
+        started_ = true;
+        return inner().await_ready();
+    }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller) {
+        using R = decltype(inner().await_suspend(caller));
+
+        if constexpr (std::same_as<R, void>) {
+            inner().await_suspend(caller);
+            return std::noop_coroutine();
+        } else if constexpr (std::same_as<R, bool>) {
+            return inner().await_suspend(caller) ? std::noop_coroutine() : caller;
+        } else {
+            return inner().await_suspend(caller);
+        }
+    }
+
+    void await_resume() {
+        if (started_) {
+            *out_ = inner().await_resume();
+        }
+    }
+
+ private:
+    Inner& inner() { return *reinterpret_cast<Inner*>(inner_); }
+
+    AsyncAndThen<F>* stage_;
+    Result<In>* in_;
+    Result<Out>* out_;
+    CancellationSlot slot_;
+    alignas(Inner) uint8_t inner_[sizeof(Inner)] /* uninitialized */;
+    bool started_ = false;
+};
+
+// Runs a synchronous stage from await_ready(), never suspends
+template <typename S, typename In, typename Out>
+struct SyncStepAwaiter {
+    bool await_ready() {
+        *out = runFused(std::move(*in), *stage);
+        return true;
+    }
+
+    void await_suspend(std::coroutine_handle<> /*caller*/) {}
+    void await_resume() {}
+
+    S* stage;
+    Result<In>* in;
+    Result<Out>* out;
+};
+
+// Runs stage S from in to out, synchronous stages complete right away.
+// Nothing runs before the awaiting frame has checked for cancellation.
+template <typename S, typename In, typename Out>
+struct [[nodiscard]] Step : supp::NonCopyable {
+    Step(S& stage, Result<In>& in, Result<Out>& out) : stage_{&stage}, in_{&in}, out_{&out} {}
+
+    // CancellableAwaitable
+    Step& setCancellationSlot(CancellationSlot slot) {
+        slot_ = slot;
+        return *this;
+    }
+
+    auto operator co_await() {
+        if constexpr (S::IsAsync) {
+            return AsyncStepAwaiter{*stage_, in_, out_, slot_};
+        } else {
+            return SyncStepAwaiter<S, In, Out>{stage_, in_, out_};
+        }
+    }
+
+ private:
+    S* stage_;
+    Result<In>* in_;
+    Result<Out>* out_;
+    CancellationSlot slot_{};
+};
+
+template <typename T, typename... Stages, size_t... Is>
+Async<PipeOutT<T, Stages...>> runStages(
+    Result<T> input, std::tuple<Stages...> stages, std::index_sequence<Is...> /*indices*/) {
+    static_assert(!std::same_as<PipeOutT<T, Stages...>, Unit>,
+        "Async<Unit> cannot return errors, end the pipeline with a value");
+
+    // results[I] is the input of stage I
+    std::tuple<Result<T>, Result<typename PipeAt<Is + 1, T, Stages...>::type>...> results;
+    std::get<0>(results) = std::move(input);
+
+    (..., co_await Step(std::get<Is>(stages), std::get<Is>(results), std::get<Is + 1>(results)));
+
+    co_return std::move(std::get<sizeof...(Stages)>(results));
+}
+
+template <typename T, typename... Stages>
+Async<PipeOutT<T, Stages...>> runAsync(Result<T> input, std::tuple<Stages...> stages) {
+    return runStages(std::move(input), std::move(stages), std::index_sequence_for<Stages...>{});
+}
+
+}  // namespace detail
+
+}  // namespace pipe
+
+/*
+ * Result<T> -> (T -> Awaitable<Result<U>>) -> Async<U>
+ *
+ * A pipeline containing asyncAndThen() stages runs in a single Async frame,
+ * synchronous stages around them run inline.
+ */
+template <typename F>
+auto asyncAndThen(F user) {
+    return pipe::AsyncAndThen{std::move(user)};
+}
+
+}  // namespace exec
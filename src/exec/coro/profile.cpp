@@ -0,0 +1,72 @@
+#include "exec/coro/profile.h"
+
+#if EXEC_AWAIT_PROFILE
+
+namespace exec::profile {
+
+namespace {
+
+static_assert(EXEC_AWAIT_PROFILE_SITES <= UINT8_MAX);
+
+AwaitSite sites_[EXEC_AWAIT_PROFILE_SITES];
+size_t count_ = 0;
+uint32_t untracked_ = 0;
+
+AwaitSite* find(const std::source_location& loc) {
+    for (size_t i = 0; i < count_; ++i) {
+        auto& s = sites_[i];
+        // file names are literals, usually merged by the linker
+        if (s.line == loc.line() &&
+            (s.file == loc.file_name() || std::strcmp(s.file, loc.file_name()) == 0)) {
+            return &s;
+        }
+    }
+
+    if (count_ == EXEC_AWAIT_PROFILE_SITES) {
+        return nullptr;
+    }
+
+    auto& s = sites_[count_++];
+    s.file = loc.file_name();
+    s.line = loc.line();
+    return &s;
+}
+
+}  // namespace
+
+void recordAwait(const std::source_location& loc, uint32_t us) {
+    auto* s = find(loc);
+    if (s == nullptr) {
+        ++untracked_;
+        return;
+    }
+
+    ++s->count;
+    s->totalUs += us;
+    s->maxUs = us > s->maxUs ? us : s->maxUs;
+}
+
+const AwaitSite* awaitSites() {
+    return sites_;
+}
+
+size_t awaitSiteCount() {
+    return count_;
+}
+
+uint32_t untrackedAwaits() {
+    return untracked_;
+}
+
+void resetAwaitSites() {
+    for (size_t i = 0; i < count_; ++i) {
+        sites_[i] = AwaitSite{};
+    }
+
+    count_ = 0;
+    untracked_ = 0;
+}
+
+}  // namespace exec::profile
+
+#endif
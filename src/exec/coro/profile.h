@@ -0,0 +1,77 @@
+#pragma once
+
+#include "exec/config.h"
+
+#include <cinttypes>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <source_location>
+
+namespace exec::profile {
+
+// Suspensions of Async bodies at a single co_await, collected with EXEC_AWAIT_PROFILE enabled.
+// co_awaits completing without suspension are not counted.
+struct AwaitSite {
+    const char* file = nullptr;
+    uint_least32_t line = 0;
+    uint32_t count = 0;
+    uint64_t totalUs = 0;
+    uint32_t maxUs = 0;
+};
+
+#if EXEC_AWAIT_PROFILE
+
+void recordAwait(const std::source_location& loc, uint32_t us);
+
+// Tracked sites in the order of their first suspension
+const AwaitSite* awaitSites();
+size_t awaitSiteCount();
+
+// Suspensions at sites that did not fit into the table
+uint32_t untrackedAwaits();
+
+void resetAwaitSites();
+
+// Calls print(const char* line) for every site, the longest total wait first
+template <typename F>
+void printAwaitSites(F&& print) {
+    const AwaitSite* sites = awaitSites();
+    const size_t n = awaitSiteCount();
+
+    uint8_t order[EXEC_AWAIT_PROFILE_SITES];
+    for (size_t i = 0; i < n; ++i) {
+        order[i] = static_cast<uint8_t>(i);
+    }
+
+    // insertion sort, the table is small
+    for (size_t i = 1; i < n; ++i) {
+        for (size_t j = i; j > 0 && sites[order[j]].totalUs > sites[order[j - 1]].totalUs; --j) {
+            const uint8_t t = order[j];
+            order[j] = order[j - 1];
+            order[j - 1] = t;
+        }
+    }
+
+    char line[96];
+    for (size_t i = 0; i < n; ++i) {
+        const AwaitSite& s = sites[order[i]];
+        const char* base = std::strrchr(s.file, '/');
+
+        std::snprintf(line, sizeof(line),
+            "%s:%" PRIuLEAST32 " count=%" PRIu32 " total=%" PRIu32 "ms max=%" PRIu32 "us",
+            base ? base + 1 : s.file, s.line, s.count, static_cast<uint32_t>(s.totalUs / 1000),
+            s.maxUs);
+        print(static_cast<const char*>(line));
+    }
+
+    if (untrackedAwaits() > 0) {
+        std::snprintf(line, sizeof(line), "untracked count=%" PRIu32, untrackedAwaits());
+        print(static_cast<const char*>(line));
+    }
+}
+
+#endif
+
+}  // namespace exec::profile
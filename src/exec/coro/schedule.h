@@ -0,0 +1,89 @@
+#pragma once
+
+#include "exec/Unit.h"
+#include "exec/coro/Async.h"
+#include "exec/coro/cancel.h"
+#include "exec/coro/traits.h"
+#include "exec/executor/Executor.h"
+
+#include <concepts>
+#include <coroutine>
+#include <utility>
+
+namespace exec {
+
+// Resumes the caller on the given executor.
+// Cancellation takes the caller back from the executor queue and resumes it inline.
+inline CancellableAwaitable auto scheduleOn(Executor* executor) {
+    struct [[nodiscard]] Awaiter : Runnable, CancellationHandler {
+        Awaiter(Executor* executor, CancellationSlot slot) : executor{executor}, slot_{slot} {}
+
+        constexpr bool await_ready() const { return false; }
+
+        void await_suspend(std::coroutine_handle<> caller) {
+            this->caller = caller;
+            slot_.installIfConnected(this);
+            executor->post(this);
+        }
+
+        constexpr Unit await_resume() { return unit; }
+
+        void run() override {
+            slot_.clearIfConnected();
+            caller.resume();
+        }
+
+        // CancellationHandler
+        std::coroutine_handle<> cancel() override {
+            // already taken by the executor, about to run
+            if (!executor->remove(this)) {
+                return std::noop_coroutine();
+            }
+
+            return caller;
+        }
+
+        Executor* const executor;
+        CancellationSlot slot_;
+        std::coroutine_handle<> caller;
+    };
+
+    struct Awaitable {
+        // CancellableAwaitable
+        Awaitable& setCancellationSlot(CancellationSlot slot) {
+            this->slot = slot;
+            return *this;
+        }
+
+        auto operator co_await() const { return Awaiter{executor, slot}; }
+
+        Executor* const executor;
+        CancellationSlot slot{};
+    };
+
+    return Awaitable{executor};
+}
+
+// Awaits the awaitable, then resumes the caller on the given executor instead of
+// the context that has completed the awaitable.
+// Cancellation is forwarded to the awaitable. Cancelled caller is resumed inline.
+// A failed Status is returned as the error of the Async<>.
+template <Awaitable A>
+Async<result_type_t<awaitable_result_t<A>>> resumeOn(Executor* executor, A awaitable) {
+    if constexpr (std::same_as<awaitable_result_t<A>, Status>) {
+        auto status = co_await std::move(awaitable);
+        co_await scheduleOn(executor);
+        if (!status) {
+            co_await detail::AsyncError{status.code()};
+        }
+    } else if constexpr (std::same_as<awaitable_result_t<A>, Unit>) {
+        (void)co_await std::move(awaitable);
+        co_await scheduleOn(executor);
+    } else {
+        auto result = co_await std::move(awaitable);
+        co_await scheduleOn(executor);
+        co_return std::move(result);
+    }
+}
+
+}  // namespace exec
@@ -1,10 +1,13 @@
 #pragma once
 
 #include "exec/Runnable.h"
+#include "exec/coro/cancel.h"
 #include "exec/coro/traits.h"
 #include "exec/executor/Executor.h"
 #include "exec/os/Service.h"
+#include "exec/trace/trace.h"
 
+#include <supp/ManualLifetime.h>
 #include <supp/NonCopyable.h>
 #include <logging/log.h>
 
@@ -19,6 +22,9 @@ template <typename T>
 struct SpawnPromise : Runnable {
     using coroutine_handle_t = std::coroutine_handle<SpawnPromise<T>>;
 
+    SpawnPromise() { trace::record(trace::Event::FrameCreate, this); }
+    ~SpawnPromise() { trace::record(trace::Event::FrameDestroy, this); }
+
     coroutine_handle_t handle() { return coroutine_handle_t::from_promise(*this); }
     auto get_return_object() { return handle(); }
     auto initial_suspend() { return std::suspend_always{}; }
@@ -45,7 +51,10 @@ struct SpawnPromise : Runnable {
     }
 
     // Runnable
-    void run() override { handle().resume(); }
+    void run() override {
+        trace::record(trace::Event::FrameResume, this);
+        handle().resume();
+    }
 };
 
 template <typename T>
@@ -69,11 +78,275 @@ SpawnTask<awaitable_result_t<A>> spawn(A task) {
     co_return co_await std::move(task);
 }
 
+// Same as SpawnPromise, but keeps the result inside of the frame until the JoinHandle<T>
+// consumes it. The frame outlives the task if the handle is still alive.
+template <typename T>
+struct JoinPromise : Runnable {
+    using coroutine_handle_t = std::coroutine_handle<JoinPromise<T>>;
+
+    template <Awaitable A>
+    JoinPromise(A&& awaitable) {
+        if constexpr (CancellableAwaitable<A>) {
+            awaitable.setCancellationSlot(sig.slot());
+        }
+
+        trace::record(trace::Event::FrameCreate, this);
+    }
+
+    ~JoinPromise() { trace::record(trace::Event::FrameDestroy, this); }
+
+    // Delivers a cancellation requested before the executor has started the task, once the
+    // awaitable has installed its handler
+    template <typename A>
+    struct StartAwaiter {
+        bool await_ready() { return impl.await_ready(); }
+
+        std::coroutine_handle<> await_suspend(coroutine_handle_t self) {
+            std::coroutine_handle<> next;
+            using R = decltype(impl.await_suspend(self));
+
+            if constexpr (std::same_as<R, void>) {
+                impl.await_suspend(self);
+                next = std::noop_coroutine();
+            } else if constexpr (std::same_as<R, bool>) {
+                if (!impl.await_suspend(self)) {
+                    return self;
+                }
+                next = std::noop_coroutine();
+            } else {
+                next = impl.await_suspend(self);
+                if (next == self) {
+                    return self;
+                }
+            }
+
+            auto& promise = self.promise();
+            if (!promise.cancelRequested) {
+                return next;
+            }
+
+            auto resumed = promise.sig.emit();
+            if (resumed == std::noop_coroutine()) {
+                return next;
+            }
+
+            if (next != std::noop_coroutine()) {
+                resumed.resume();
+                return next;
+            }
+
+            return resumed;
+        }
+
+        decltype(auto) await_resume() { return std::move(impl).await_resume(); }
+
+        A impl;
+    };
+
+    template <typename A>
+    auto await_transform(A&& awaitable) {
+        return StartAwaiter<get_awaiter_t<A>>{std::forward<A>(awaitable).operator co_await()};
+    }
+
+    coroutine_handle_t handle() { return coroutine_handle_t::from_promise(*this); }
+    auto get_return_object() { return handle(); }
+    auto initial_suspend() { return std::suspend_always{}; }
+
+    auto final_suspend() const noexcept {
+        struct Finalizer {
+            constexpr bool await_ready() const noexcept { return false; }
+
+            std::coroutine_handle<> await_suspend(coroutine_handle_t coroutine) noexcept {
+                auto& promise = coroutine.promise();
+
+                if (promise.detached) {
+                    coroutine.destroy();
+                    return std::noop_coroutine();
+                }
+
+                // The frame is kept alive until the handle is joined or dropped.
+                trace::record(trace::Event::FrameSuspend, &promise);
+                return std::exchange(promise.joiner, std::noop_coroutine());
+            }
+
+            void await_resume() noexcept { DASSERT(false, "implementation bug"); }
+        };
+
+        return Finalizer{};
+    }
+
+    template <typename U>
+    void return_value(U&& value) {
+        result.emplace(std::forward<U>(value));
+    }
+
+    void unhandled_exception() {
+        LFATAL("unhandled exception in spawned task");
+        abort();
+    }
+
+    // Runnable
+    void run() override {
+        trace::record(trace::Event::FrameResume, this);
+        handle().resume();
+    }
+
+    // Cancels the task, or the start of it when the executor has not run it yet
+    [[nodiscard]] std::coroutine_handle<> requestCancel() {
+        cancelRequested = true;
+        return sig.emit();
+    }
+
+    supp::ManualLifetime<T> result;
+    std::coroutine_handle<> joiner = std::noop_coroutine();
+    CancellationSignal sig;
+    bool detached = false;
+    bool cancelRequested = false;
+};
+
+template <typename T>
+struct JoinTask : supp::NonCopyable {
+ public:
+    using promise_type = JoinPromise<T>;
+    using coroutine_handle_t = std::coroutine_handle<promise_type>;
+
+    JoinTask(coroutine_handle_t coro) : coroutine_{coro} {}
+    JoinTask(JoinTask&& r) noexcept : coroutine_{std::exchange(r.coroutine_, nullptr)} {}
+    ~JoinTask() { DASSERT(!coroutine_, F("JoinTask<T> not spawned")); }
+
+    coroutine_handle_t release() && { return std::exchange(coroutine_, nullptr); }
+
+ private:
+    coroutine_handle_t coroutine_;
+};
+
+template <Awaitable A>
+JoinTask<awaitable_result_t<A>> spawnJoinable(A task) {
+    // task is passed to JoinPromise's constructor
+    co_return co_await std::move(task);
+}
+
 }  // namespace detail
 
+// CancellableAwaitable
+// Owning handle to a spawned task. co_await'ing it yields the task's result.
+// Cancellation of the co_await is forwarded to the task, the handle still waits for it to finish.
+// Dropping the handle detaches the task.
+template <typename T>
+class [[nodiscard]] JoinHandle : supp::NonCopyable {
+    using coroutine_handle_t = std::coroutine_handle<detail::JoinPromise<T>>;
+
+    struct Awaiter : CancellationHandler {
+        Awaiter(coroutine_handle_t coroutine, CancellationSlot slot)
+            : coroutine_{coroutine}
+            , slot_{slot} {}
+
+        ~Awaiter() {
+            if (coroutine_) {
+                // the awaiting coroutine has been discarded
+                JoinHandle::detach(coroutine_);
+            }
+        }
+
+        bool await_ready() const { return coroutine_.done(); }
+
+        void await_suspend(std::coroutine_handle<> caller) {
+            coroutine_.promise().joiner = caller;
+            slot_.installIfConnected(this);
+        }
+
+        T await_resume() {
+            slot_.clearIfConnected();
+
+            auto coroutine = std::exchange(coroutine_, nullptr);
+            T result = std::move(coroutine.promise().result).get();
+            coroutine.destroy();
+            return result;
+        }
+
+     private:
+        // CancellationHandler
+        std::coroutine_handle<> cancel() override { return coroutine_.promise().requestCancel(); }
+
+        coroutine_handle_t coroutine_;
+        CancellationSlot slot_;
+    };
+
+ public:
+    JoinHandle(coroutine_handle_t coroutine) : coroutine_{coroutine} {}
+    JoinHandle(JoinHandle&& r) noexcept
+        : coroutine_{std::exchange(r.coroutine_, nullptr)}
+        , slot_{r.slot_} {}
+
+    ~JoinHandle() { detach(); }
+
+    bool done() const {
+        DASSERT(coroutine_, F("JoinHandle<T> has been consumed"));
+        return coroutine_.done();
+    }
+
+    // Lets the task run to completion on its own, its result is discarded.
+    void detach() {
+        if (coroutine_) {
+            detach(std::exchange(coroutine_, nullptr));
+        }
+    }
+
+    // Requests cancellation of the task without waiting for it.
+    // A task which has not been started yet is cancelled as soon as it starts.
+    void requestCancel() {
+        DASSERT(coroutine_, F("JoinHandle<T> has been consumed"));
+        coroutine_.promise().requestCancel().resume();
+    }
+
+    // CancellableAwaitable
+    JoinHandle& setCancellationSlot(CancellationSlot slot) {
+        slot_ = slot;
+        return *this;
+    }
+
+    Awaiter operator co_await() {
+        DASSERT(coroutine_, F("JoinHandle<T> has been consumed"));
+        return Awaiter{std::exchange(coroutine_, nullptr), slot_};
+    }
+
+ private:
+    static void detach(coroutine_handle_t coroutine) {
+        if (coroutine.done()) {
+            coroutine.destroy();
+        } else {
+            coroutine.promise().detached = true;
+        }
+    }
+
+    coroutine_handle_t coroutine_;
+    CancellationSlot slot_{};
+};
+
+// Starts the task on the given executor.
+template <Awaitable A>
+void spawn(Executor* executor, A&& awaitable) {
+    executor->post(detail::spawn(std::forward<A>(awaitable)).promise());
+}
+
 template <Awaitable A>
 void spawn(A&& awaitable) {
-    service<Executor>()->post(detail::spawn(std::forward<A>(awaitable)).promise());
+    spawn(service<Executor>(), std::forward<A>(awaitable));
+}
+
+// Same as spawn(), but the result can be obtained through the returned handle.
+// The result is stored in the spawned frame, so no extra allocations are made.
+template <Awaitable A>
+JoinHandle<awaitable_result_t<std::remove_cvref_t<A>>> spawnWithHandle(
+    Executor* executor, A&& awaitable) {
+    auto coroutine = detail::spawnJoinable(std::forward<A>(awaitable)).release();
+    executor->post(&coroutine.promise());
+    return {coroutine};
+}
+
+template <Awaitable A>
+JoinHandle<awaitable_result_t<std::remove_cvref_t<A>>> spawnWithHandle(A&& awaitable) {
+    return spawnWithHandle(service<Executor>(), std::forward<A>(awaitable));
 }
 
 }  // namespace exec
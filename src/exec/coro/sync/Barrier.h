@@ -0,0 +1,108 @@
+#pragma once
+
+#include "exec/Error.h"
+#include "exec/coro/cancel.h"
+#include "exec/coro/traits.h"
+
+#include <supp/IntrusiveList.h>
+#include <supp/NonCopyable.h>
+#include <supp/Pinned.h>
+
+#include <coroutine>
+#include <cstddef>
+
+namespace exec {
+
+// Reusable rendezvous of a fixed number of participants.
+// The last one to arrive does not suspend, it releases the others and starts the next phase.
+class Barrier : supp::Pinned {
+ public:
+    explicit Barrier(size_t participants) : participants_{participants}, remaining_{participants} {
+        DASSERT(participants > 0);
+    }
+
+    ~Barrier() { DASSERT(parked_.empty(), F("destroyed with parked participants")); }
+
+    // Number of completed phases
+    size_t phase() const { return phase_; }
+
+    // A cancelled participant is not counted as arrived anymore.
+    CancellableAwaitable auto arriveAndWait() { return Awaitable{this}; }
+
+ private:
+    struct Awaiter : CancellationHandler, supp::IntrusiveListNode {
+     public:
+        Awaiter(Barrier* self, CancellationSlot slot) : self_{self}, slot_{slot} {}
+
+        bool await_ready() { return self_->arrive(); }
+
+        void await_suspend(std::coroutine_handle<> caller) {
+            slot_.installIfConnected(this);
+            caller_ = caller;
+            self_->parked_.pushBack(this);
+        }
+
+        ErrCode await_resume() const {
+            return self_ == nullptr ? ErrCode::Cancelled : ErrCode::Success;
+        }
+
+        // CancellationHandler
+        std::coroutine_handle<> cancel() override {
+            unlink();
+            ++self_->remaining_;
+            self_ = nullptr;
+            return caller_;
+        }
+
+        void released() {
+            slot_.clearIfConnected();
+            caller_.resume();
+        }
+
+     private:
+        Barrier* self_;
+        CancellationSlot slot_;
+        std::coroutine_handle<> caller_ = nullptr;
+    };
+
+    struct [[nodiscard]] Awaitable : supp::NonCopyable {
+        Awaitable(Barrier* self) : self_{self} {}
+
+        // CancellableAwaitable
+        Awaitable& setCancellationSlot(CancellationSlot slot) {
+            slot_ = slot;
+            return *this;
+        }
+
+        Awaiter operator co_await() { return Awaiter{self_, slot_}; }
+
+     private:
+        Barrier* self_;
+        CancellationSlot slot_;
+    };
+
+    // Returns true for the last participant of the phase
+    bool arrive() {
+        if (--remaining_ != 0) {
+            return false;
+        }
+
+        remaining_ = participants_;
+        ++phase_;
+
+        // participants arriving while being released belong to the next phase
+        auto parked(std::move(parked_));
+        while (!parked.empty()) {
+            parked.popFront()->released();
+        }
+
+        return true;
+    }
+
+    supp::IntrusiveList<Awaiter> parked_;
+    const size_t participants_;
+    size_t remaining_;
+    size_t phase_ = 0;
+};
+
+}  // namespace exec
@@ -0,0 +1,300 @@
+#pragma once
+
+#include "exec/Error.h"
+#include "exec/result/Result.h"
+#include "exec/Unit.h"
+#include "exec/coro/cancel.h"
+#include "exec/coro/traits.h"
+
+#include <supp/IntrusiveList.h>
+#include <supp/NonCopyable.h>
+#include <supp/Pinned.h>
+
+#include <algorithm>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace exec {
+
+enum class BroadcastPolicy : uint8_t {
+    DropOldest,  // producers never wait, lagging subscribers lose the oldest values
+    Block,       // producers wait until the slowest subscriber makes room
+};
+
+// Every subscriber receives every value sent after it has subscribed.
+// Values are stored once in a shared ring, each subscriber has its own read cursor.
+//
+// A subscriber that is more than N values behind with BroadcastPolicy::DropOldest
+// gets ErrCode::Lagged once and then continues with the oldest value still stored.
+template <typename T, size_t N, BroadcastPolicy Policy = BroadcastPolicy::DropOldest>
+class BroadcastChannel : supp::Pinned {
+    static_assert(N > 0 && (N & (N - 1)) == 0, "N must be a power of two");
+
+    using Seq = uint32_t;
+
+    struct Awaiter;
+    struct ReceiveAwaiter;
+    struct SendAwaiter;
+    struct ReceiveAwaitable;
+    struct SendAwaitable;
+
+ public:
+    class Subscriber : public supp::IntrusiveListNode, supp::Pinned {
+     public:
+        ~Subscriber() {
+            unlink();
+            channel_->pump();  // may have been the slowest one
+        }
+
+        // Returns ErrCode::Exhausted if there is no value to receive.
+        Result<T> tryReceive() {
+            auto res = take();
+            if (Policy == BroadcastPolicy::Block && res) {
+                channel_->pump();
+            }
+            return res;
+        }
+
+        CancellableAwaitable auto receive() { return ReceiveAwaitable{this}; }
+
+        // Number of values ready to be received
+        size_t pending() const { return std::min<size_t>(channel_->head_ - next_, N); }
+
+        // Number of values lost because of lagging behind
+        size_t missed() const { return missed_; }
+
+     private:
+        friend class BroadcastChannel;
+
+        explicit Subscriber(BroadcastChannel* channel) : channel_{channel}, next_{channel->head_} {
+            channel->subscribers_.pushBack(this);
+        }
+
+        Result<T> take() {
+            const Seq head = channel_->head_;
+            if (head - next_ > N) {
+                missed_ += head - next_ - N;
+                next_ = head - N;
+                return err<T>(ErrCode::Lagged);
+            }
+
+            if (head == next_) {
+                return err<T>(ErrCode::Exhausted);
+            }
+
+            return channel_->ring_[next_++ % N];
+        }
+
+        BroadcastChannel* channel_;
+        Seq next_;
+        size_t missed_ = 0;
+    };
+
+    BroadcastChannel() = default;
+
+    ~BroadcastChannel() {
+        DASSERT(subscribers_.empty(), F("subscribers must not outlive the channel"));
+    }
+
+    // The subscriber receives values sent from now on
+    Subscriber subscribe() { return Subscriber{this}; }
+
+    // Moves the value into the channel if that does not require waiting.
+    bool trySend(T& value) {
+        if (!senders_.empty() || !hasRoom()) {
+            return false;
+        }
+
+        publish(std::move(value));
+        pump();
+        return true;
+    }
+
+    CancellableAwaitable auto send(T& value) { return SendAwaitable{this, &value}; }
+
+ private:
+    struct Awaiter : CancellationHandler, supp::IntrusiveListNode {
+     public:
+        explicit Awaiter(CancellationSlot slot) : slot{slot} {}
+
+        template <typename A>
+        void park(supp::IntrusiveList<A>& parked, std::coroutine_handle<> a_caller) {
+            caller = a_caller;
+            slot.installIfConnected(this);
+            parked.pushBack(static_cast<A*>(this));
+        }
+
+        void wake() {
+            slot.clearIfConnected();
+            caller.resume();
+        }
+
+     protected:
+        // CancellationHandler
+        std::coroutine_handle<> cancel() override {
+            unlink();
+            cancelled = true;
+            return caller;
+        }
+
+        CancellationSlot slot;
+        std::coroutine_handle<> caller = nullptr;
+        bool cancelled = false;
+    };
+
+    struct ReceiveAwaiter : Awaiter {
+     public:
+        ReceiveAwaiter(Subscriber* sub, CancellationSlot slot) : Awaiter(slot), sub{sub} {}
+
+        bool await_ready() {
+            result = sub->tryReceive();
+            return result.code() != ErrCode::Exhausted;
+        }
+
+        void await_suspend(std::coroutine_handle<> a_caller) {
+            this->park(sub->channel_->receivers_, a_caller);
+        }
+
+        Result<T> await_resume() {
+            return this->cancelled ? err<T>(ErrCode::Cancelled) : std::move(result);
+        }
+
+        // Returns false if there is nothing to receive yet
+        bool take() {
+            result = sub->take();
+            return result.code() != ErrCode::Exhausted;
+        }
+
+     private:
+        Subscriber* sub;
+        Result<T> result;
+    };
+
+    struct SendAwaiter : Awaiter {
+     public:
+        SendAwaiter(BroadcastChannel* self, CancellationSlot slot, T* value)
+            : Awaiter(slot)
+            , self{self}
+            , value{value} {}
+
+        bool await_ready() {
+            sent = self->trySend(*value);
+            return sent;
+        }
+
+        void await_suspend(std::coroutine_handle<> a_caller) {
+            this->park(self->senders_, a_caller);
+        }
+
+        Result<Unit> await_resume() const { return sent ? ok() : err<Unit>(ErrCode::Cancelled); }
+
+        T take() {
+            sent = true;
+            return std::move(*value);
+        }
+
+     private:
+        BroadcastChannel* self;
+        T* value;
+        bool sent = false;
+    };
+
+    struct [[nodiscard]] ReceiveAwaitable : supp::NonCopyable {
+        // the value is handed over while resuming the receiver, see Selectable
+        static constexpr bool HandsOverInline = true;
+
+        ReceiveAwaitable(Subscriber* sub) : sub_{sub} {}
+
+        // CancellableAwaitable
+        ReceiveAwaitable& setCancellationSlot(CancellationSlot slot) {
+            slot_ = slot;
+            return *this;
+        }
+
+        ReceiveAwaiter operator co_await() { return ReceiveAwaiter{sub_, slot_}; }
+
+     private:
+        Subscriber* sub_;
+        CancellationSlot slot_{};
+    };
+
+    struct [[nodiscard]] SendAwaitable : supp::NonCopyable {
+        SendAwaitable(BroadcastChannel* self, T* value) : self_{self}, value_{value} {}
+
+        // CancellableAwaitable
+        SendAwaitable& setCancellationSlot(CancellationSlot slot) {
+            slot_ = slot;
+            return *this;
+        }
+
+        SendAwaiter operator co_await() { return SendAwaiter{self_, slot_, value_}; }
+
+     private:
+        BroadcastChannel* self_;
+        T* value_;
+        CancellationSlot slot_{};
+    };
+
+    bool hasRoom() const {
+        if constexpr (Policy == BroadcastPolicy::DropOldest) {
+            return true;
+        }
+
+        bool room = true;
+        subscribers_.iterate([&](const Subscriber& sub) { room = room && head_ - sub.next_ < N; });
+        return room;
+    }
+
+    void publish(T&& value) {
+        ring_[head_ % N] = std::move(value);
+        ++head_;
+    }
+
+    // Moves values of parked senders into the ring while there is room,
+    // hands them to parked receivers and then wakes up everybody in a single pass.
+    void pump() {
+        supp::IntrusiveList<Awaiter> ready;
+
+        for (bool progress = true; progress;) {
+            progress = false;
+
+            while (!senders_.empty() && hasRoom()) {
+                auto* sender = senders_.popFront();
+                publish(sender->take());
+                ready.pushBack(sender);
+                progress = true;
+            }
+
+            // several receivers may share a subscriber: the first one takes the value,
+            // the others keep waiting without holding up receivers of other subscribers
+            supp::IntrusiveList<ReceiveAwaiter> waiting;
+            while (!receivers_.empty()) {
+                auto* receiver = receivers_.popFront();
+                if (receiver->take()) {
+                    ready.pushBack(receiver);
+                    progress = true;
+                } else {
+                    waiting.pushBack(receiver);
+                }
+            }
+
+            while (!waiting.empty()) {
+                receivers_.pushBack(waiting.popFront());
+            }
+        }
+
+        while (!ready.empty()) {
+            ready.popFront()->wake();
+        }
+    }
+
+    T ring_[N]{};
+    Seq head_ = 0;  // sequence number of the next value
+    supp::IntrusiveList<Subscriber> subscribers_;
+    supp::IntrusiveList<SendAwaiter> senders_;
+    supp::IntrusiveList<ReceiveAwaiter> receivers_;
+};
+
+}  // namespace exec
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "exec/Error.h"
+#include "exec/coro/cancel.h"
+#include "exec/coro/sync/Mutex.h"
+#include "exec/coro/traits.h"
+
+#include <supp/IntrusiveList.h>
+#include <supp/NonCopyable.h>
+#include <supp/Pinned.h>
+
+#include <coroutine>
+#include <utility>
+
+namespace exec {
+
+// wait() releases the mutex and parks until notified.
+// Notified waiters are queued on the mutex and get the lock directly from Mutex::unlock,
+// so the guard owns the lock again when wait() completes, also when cancelled.
+// Works with the handing-over Mutex.
+class ConditionVariable : supp::Pinned {
+ public:
+    ConditionVariable() = default;
+
+    ~ConditionVariable() { DASSERT(parked_.empty(), F("destroyed with parked waiters")); }
+
+    CancellableAwaitable auto wait(LockGuard& guard) { return Awaitable{this, &guard}; }
+
+    void notifyOne() {
+        if (!parked_.empty()) {
+            parked_.popFront()->notified();
+        }
+    }
+
+    void notifyAll() {
+        // coroutines waiting again while being notified wait for the next notification
+        auto parked(std::move(parked_));
+
+        while (!parked.empty()) {
+            parked.popFront()->notified();
+        }
+    }
+
+ private:
+    struct Awaiter : Mutex::Awaiter {
+        Awaiter(ConditionVariable* cv, LockGuard* guard, CancellationSlot slot)
+            : Mutex::Awaiter(guard->self_, slot)
+            , cv_{cv}
+            , guard_{guard} {
+            DASSERT(self_ != nullptr, F("waiting with an unlocked guard"));
+        }
+
+        bool await_ready() const { return false; }
+
+        void await_suspend(std::coroutine_handle<> caller) {
+            slot_.installIfConnected(this);
+            caller_ = caller;
+            cv_->parked_.pushBack(this);
+
+            // may hand the lock over and resume another coroutine right away
+            std::move(*guard_).unlock();
+        }
+
+        ErrCode await_resume() {
+            *guard_ = LockGuard{self_};
+            return waitCancelled_ ? ErrCode::Cancelled : ErrCode::Success;
+        }
+
+        void notified() {
+            slot_.clearIfConnected();
+
+            if (self_->lockOrPark(this)) {
+                caller_.resume();
+            }
+        }
+
+     private:
+        // CancellationHandler
+        std::coroutine_handle<> cancel() override {
+            unlink();
+            waitCancelled_ = true;
+
+            // the lock has to be taken back before resuming
+            return self_->lockOrPark(this) ? caller_ : std::noop_coroutine();
+        }
+
+        ConditionVariable* cv_;
+        LockGuard* guard_;
+        // the wait, not the lock: the lock is always taken back
+        bool waitCancelled_ = false;
+    };
+
+    struct [[nodiscard]] Awaitable : supp::NonCopyable {
+     public:
+        Awaitable(ConditionVariable* self, LockGuard* guard) : self_{self}, guard_{guard} {}
+
+        // CancellableAwaitable
+        Awaitable& setCancellationSlot(CancellationSlot slot) {
+            slot_ = slot;
+            return *this;
+        }
+
+        Awaiter operator co_await() { return Awaiter{self_, guard_, slot_}; }
+
+     private:
+        ConditionVariable* self_;
+        LockGuard* guard_;
+        CancellationSlot slot_{};
+    };
+
+    supp::IntrusiveList<Awaiter> parked_;
+};
+
+}  // namespace exec
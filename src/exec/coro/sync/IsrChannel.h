@@ -0,0 +1,183 @@
+#pragma once
+
+#include "exec/Error.h"
+#include "exec/Runnable.h"
+#include "exec/result/Result.h"
+#include "exec/coro/cancel.h"
+#include "exec/coro/traits.h"
+#include "exec/executor/Executor.h"
+#include "exec/os/OS.h"
+
+#include <supp/NonCopyable.h>
+#include <supp/Pinned.h>
+
+#include <time/mono.h>
+
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+namespace exec {
+
+// Single-producer single-consumer channel fed from an interrupt handler.
+//
+// pushFromIsr() is wait-free and never touches the executor: values that do not fit
+// are dropped and counted. Everything shared with the interrupt handler is a single byte,
+// so that it is read and written atomically on 8-bit targets as well. The channel is a Service: when a receiver is parked and the ring
+// has become non-empty, tick() posts the receiver to the Executor.
+// The receiver drains the ring without suspending while it is non-empty.
+//
+// Registers itself in the OS, so the OS must be created first.
+template <typename T, size_t N>
+class IsrChannel : public Service, supp::Pinned {
+    static_assert(std::is_trivially_copyable_v<T>, "values are copied in interrupt context");
+    static_assert(N > 0);
+    static_assert(N < UINT8_MAX, "ring indices are single bytes");
+
+    using Index = uint8_t;
+    static constexpr Index Slots = N + 1;
+
+ public:
+    IsrChannel() { OS::globalAddService(this); }
+
+    // Producer side, may be called from an interrupt handler.
+    // Returns false if the ring is full, the value is dropped.
+    bool pushFromIsr(const T& value) {
+        const Index tail = tail_.load(std::memory_order_relaxed);
+        const Index next = advance(tail);
+
+        if (next == head_.load(std::memory_order_acquire)) {
+            // wraps around, the consumer accumulates the difference
+            dropped_.store(++isrDropped_, std::memory_order_relaxed);
+            return false;
+        }
+
+        slots_[tail] = value;
+        tail_.store(next, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side
+    Result<T> tryReceive() {
+        collectOverflows();
+
+        const Index head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire)) {
+            return err<T>(ErrCode::Exhausted);
+        }
+
+        T value = slots_[head];
+        head_.store(advance(head), std::memory_order_release);
+        return value;
+    }
+
+    CancellableAwaitable auto receive() { return Awaitable{this}; }
+
+    bool empty() const {
+        return head_.load(std::memory_order_relaxed) == tail_.load(std::memory_order_acquire);
+    }
+
+    // Number of values dropped because the ring was full.
+    // Exact as long as the consumer side (tryReceive(), receive(), tick() or overflows()) runs
+    // at least once per 255 dropped values.
+    uint32_t overflows() {
+        collectOverflows();
+        return overflows_;
+    }
+
+    // Service
+    void tick() override {
+        collectOverflows();
+
+        if (parked_ == nullptr || empty()) {
+            return;
+        }
+
+        std::exchange(parked_, nullptr)->commit();
+    }
+
+    ttime::Time wakeAt() const override {
+        return parked_ != nullptr && !empty() ? ttime::mono::now() : ttime::Time::max();
+    }
+
+ private:
+    struct Awaiter : CancellationHandler, Runnable {
+        Awaiter(IsrChannel* self, CancellationSlot slot) : self_{self}, slot_{slot} {}
+
+        bool await_ready() {
+            result_ = self_->tryReceive();
+            return result_.hasValue();
+        }
+
+        void await_suspend(std::coroutine_handle<> caller) {
+            DASSERT(self_->parked_ == nullptr, F("IsrChannel supports a single receiver"));
+            caller_ = caller;
+            slot_.installIfConnected(this);
+            self_->parked_ = this;
+        }
+
+        Result<T> await_resume() { return std::move(result_); }
+
+        // A value is available: takes it and schedules the receiver.
+        // Cannot be cancelled from now on.
+        void commit() {
+            slot_.clearIfConnected();
+            result_ = self_->tryReceive();
+            service<Executor>()->post(this);
+        }
+
+     private:
+        // CancellationHandler
+        std::coroutine_handle<> cancel() override {
+            self_->parked_ = nullptr;
+            result_.setError(ErrCode::Cancelled);
+            return caller_;
+        }
+
+        // Runnable
+        void run() override { caller_.resume(); }
+
+        IsrChannel* self_;
+        CancellationSlot slot_;
+        std::coroutine_handle<> caller_ = nullptr;
+        Result<T> result_;
+    };
+
+    struct [[nodiscard]] Awaitable : supp::NonCopyable {
+        Awaitable(IsrChannel* self) : self_{self} {}
+
+        // CancellableAwaitable
+        Awaitable& setCancellationSlot(CancellationSlot slot) {
+            slot_ = slot;
+            return *this;
+        }
+
+        Awaiter operator co_await() { return Awaiter{self_, slot_}; }
+
+     private:
+        IsrChannel* self_;
+        CancellationSlot slot_{};
+    };
+
+    static Index advance(Index i) { return i + 1 == Slots ? 0 : i + 1; }
+
+    void collectOverflows() {
+        const uint8_t dropped = dropped_.load(std::memory_order_relaxed);
+        overflows_ += static_cast<uint8_t>(dropped - seenDropped_);
+        seenDropped_ = dropped;
+    }
+
+    T slots_[Slots];
+    std::atomic<Index> head_{0};  // written by the consumer
+    std::atomic<Index> tail_{0};  // written by the producer
+    uint8_t isrDropped_ = 0;            // producer's own wrapping count
+    std::atomic<uint8_t> dropped_{0};   // published by the producer
+    uint8_t seenDropped_ = 0;           // consumer's last look at dropped_
+    uint32_t overflows_ = 0;            // consumer's total
+    Awaiter* parked_ = nullptr;
+};
+
+}  // namespace exec
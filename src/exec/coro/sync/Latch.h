@@ -0,0 +1,97 @@
+#pragma once
+
+#include "exec/Error.h"
+#include "exec/coro/cancel.h"
+#include "exec/coro/traits.h"
+
+#include <supp/IntrusiveList.h>
+#include <supp/NonCopyable.h>
+#include <supp/Pinned.h>
+
+#include <coroutine>
+#include <cstddef>
+
+namespace exec {
+
+// Single-use countdown: waiters are released once the counter reaches zero.
+class Latch : supp::Pinned {
+ public:
+    explicit Latch(size_t count) : count_{count} {}
+
+    bool ready() const { return count_ == 0; }
+
+    void countDown(size_t n = 1) {
+        DASSERT(n <= count_);
+
+        count_ -= n;
+        if (count_ == 0) {
+            releaseAll();
+        }
+    }
+
+    CancellableAwaitable auto wait() { return Awaitable{this}; }
+
+ private:
+    struct Awaiter : CancellationHandler, supp::IntrusiveListNode {
+     public:
+        Awaiter(Latch* self, CancellationSlot slot) : self_{self}, slot_{slot} {}
+
+        bool await_ready() const { return self_->ready(); }
+
+        void await_suspend(std::coroutine_handle<> caller) {
+            slot_.installIfConnected(this);
+            caller_ = caller;
+            self_->parked_.pushBack(this);
+        }
+
+        ErrCode await_resume() const {
+            return self_ == nullptr ? ErrCode::Cancelled : ErrCode::Success;
+        }
+
+        // CancellationHandler
+        std::coroutine_handle<> cancel() override {
+            unlink();
+            self_ = nullptr;
+            return caller_;
+        }
+
+        void released() {
+            slot_.clearIfConnected();
+            caller_.resume();
+        }
+
+     private:
+        Latch* self_;
+        CancellationSlot slot_;
+        std::coroutine_handle<> caller_ = nullptr;
+    };
+
+    struct [[nodiscard]] Awaitable : supp::NonCopyable {
+        Awaitable(Latch* self) : self_{self} {}
+
+        // CancellableAwaitable
+        Awaitable& setCancellationSlot(CancellationSlot slot) {
+            slot_ = slot;
+            return *this;
+        }
+
+        Awaiter operator co_await() { return Awaiter{self_, slot_}; }
+
+     private:
+        Latch* self_;
+        CancellationSlot slot_;
+    };
+
+    void releaseAll() {
+        auto parked(std::move(parked_));
+
+        while (!parked.empty()) {
+            parked.popFront()->released();
+        }
+    }
+
+    supp::IntrusiveList<Awaiter> parked_;
+    size_t count_;
+};
+
+}  // namespace exec
@@ -8,27 +8,83 @@
 
 #include <supp/CircularBuffer.h>
 #include <supp/IntrusiveList.h>
-#include <supp/ManualLifetime.h>
 #include <supp/NonCopyable.h>
 
+#include <algorithm>
+#include <concepts>
 #include <coroutine>
 #include <cstddef>
+#include <cstdint>
+#include <new>
+#include <span>
+#include <tuple>
+#include <type_traits>
 #include <utility>
 
 namespace exec {
 
+// Every operation moves as many values as it can at once and then wakes up
+// all parked peers that can make progress in a single pass.
+// Senders are parked only when the buffer is full, receivers only when it is empty.
 template <typename T, size_t Capacity>
 class MPMCChannel {
+    struct Awaiter;
+    struct Producer;
+    struct Consumer;
+    struct ReceiveAwaiter;
+    struct ReceiveManyAwaiter;
+    struct SendAwaiter;
+    struct SendManyAwaiter;
+
+    template <typename... Args>
+    struct EmplaceAwaiter;
+
+    template <typename A, typename... Args>
+    struct Operation;
+
  public:
     MPMCChannel() = default;
 
-    CancellableAwaitable auto receive() { return Receive{this}; }
-    CancellableAwaitable auto send(T& value) { return Send{this, &value}; }
+    CancellableAwaitable auto receive() { return Operation<ReceiveAwaiter>{this}; }
+    CancellableAwaitable auto send(T& value) { return Operation<SendAwaiter, T*>{this, &value}; }
+
+    // Constructs the value from args once there is room for it.
+    template <typename... Args>
+    CancellableAwaitable auto emplace(Args&&... args) {
+        using Tuple = std::tuple<std::decay_t<Args>...>;
+        return Operation<EmplaceAwaiter<std::decay_t<Args>...>, Tuple>{
+            this, Tuple(std::forward<Args>(args)...)};
+    }
+
+    // Moves all values into the channel, in order.
+    // Returns the number of values sent, which is less than values.size() only if cancelled.
+    CancellableAwaitable auto sendMany(std::span<T> values) {
+        return Operation<SendManyAwaiter, std::span<T>>{this, values};
+    }
+
+    // Receives at least min and at most max values into out.
+    // Returns the number of values received, which is less than min only if cancelled.
+    CancellableAwaitable auto receiveMany(std::span<T> out, size_t min, size_t max) {
+        DASSERT(min <= max && max <= out.size());
+        return Operation<ReceiveManyAwaiter, std::span<T>, size_t, size_t>{this, out, min, max};
+    }
 
  private:
-    struct Awaitable : CancellationHandler, supp::IntrusiveListNode {
+    struct Awaiter : CancellationHandler, supp::IntrusiveListNode {
      public:
-        Awaitable(MPMCChannel* self, CancellationSlot slot) : self{self}, slot{slot} {}
+        Awaiter(MPMCChannel* self, CancellationSlot slot) : self{self}, slot{slot} {}
+
+        template <typename A>
+        void park(supp::IntrusiveList<A>& parked, std::coroutine_handle<> a_caller) {
+            caller = a_caller;
+            slot.installIfConnected(this);
+            parked.pushBack(static_cast<A*>(this));
+        }
+
+        void wake() {
+            slot.clearIfConnected();
+            caller.resume();
+        }
 
      protected:
         // CancellationHandler
@@ -43,136 +99,258 @@ class MPMCChannel {
         std::coroutine_handle<> caller = nullptr;
     };
 
-    struct ReceiveAwaiter : Awaitable {
-     public:
-        using Awaitable::Awaitable;
+    // Source of values to be sent, taken from a span in runs
+    struct Producer : Awaiter {
+        Producer(MPMCChannel* self, CancellationSlot slot, std::span<T> values)
+            : Awaiter(self, slot)
+            , values{values} {}
 
-        bool await_ready() {
-            if (self->buf_.full() && !self->parked_.empty()) {
-                result.emplace(self->buf_.pop());
+        bool drained() const { return sent == values.size(); }
 
-                auto* sender = static_cast<SendAwaiter*>(self->parked_.popFront());
-                sender->resume();
-                return true;
+        // Takes up to n values not sent yet, in order
+        std::span<T> take(size_t n) {
+            if (sent == 0 && n > 0) {
+                prepare();
             }
 
-            if (!self->buf_.empty()) {
-                result.emplace(self->buf_.pop());
-                return true;
+            auto run = values.subspan(sent, std::min(n, values.size() - sent));
+            sent += run.size();
+            return run;
+        }
+
+        bool await_ready() { return Awaiter::self->push(this); }
+        void await_suspend(std::coroutine_handle<> a_caller) {
+            this->park(Awaiter::self->senders_, a_caller);
+        }
+
+     protected:
+        // Called once, before the first value is taken
+        virtual void prepare() {}
+
+        const std::span<T> values;
+        size_t sent = 0;
+    };
+
+    // Destination of received values: a span, or a single Result<T> for receive()
+    struct Consumer : Awaiter {
+        Consumer(MPMCChannel* self, CancellationSlot slot, std::span<T> out, size_t min)
+            : Awaiter(self, slot)
+            , out{out}
+            , min{min}
+            , max{out.size()} {}
+
+        Consumer(MPMCChannel* self, CancellationSlot slot, Result<T>* one)
+            : Awaiter(self, slot)
+            , one{one}
+            , min{1}
+            , max{1} {}
+
+        bool satisfied() const { return count >= min; }  // may be resumed
+        bool full() const { return count == max; }       // cannot take any more values
+        size_t room() const { return max - count; }
+
+        void give(T&& value) {
+            if (one != nullptr) {
+                one->emplace(std::move(value));
+                ++count;
+            } else {
+                out[count++] = std::move(value);
             }
+        }
 
-            // buffer is empty and there is no awaiting sender: park
-            return false;
+        // values.size() <= room()
+        void give(std::span<T> values) {
+            if (one != nullptr) {
+                for (auto& value : values) {
+                    give(std::move(value));
+                }
+            } else {
+                std::move(values.begin(), values.end(), out.begin() + count);
+                count += values.size();
+            }
         }
 
+        bool await_ready() { return Awaiter::self->pull(this); }
         void await_suspend(std::coroutine_handle<> a_caller) {
-            caller = a_caller;
-            slot.installIfConnected(this);
-            self->parked_.pushBack(this);
+            this->park(Awaiter::self->receivers_, a_caller);
         }
 
-        Result<T> await_resume() { return result ? std::move(result) : err<T>(ErrCode::Cancelled); }
+     protected:
+        const std::span<T> out{};
+        Result<T>* const one = nullptr;
+        const size_t min;
+        const size_t max;
+        size_t count = 0;
+    };
 
-        void resume(T* val) {
-            slot.clearIfConnected();
-            result.emplace(std::move(*val));
-            caller.resume();
-        }
+    struct ReceiveAwaiter : Consumer {
+     public:
+        ReceiveAwaiter(MPMCChannel* self, CancellationSlot slot) : Consumer(self, slot, &result) {}
 
-     private:
-        using Awaitable::caller;
-        using Awaitable::self;
-        using Awaitable::slot;
+        Result<T> await_resume() { return result ? std::move(result) : err<T>(ErrCode::Cancelled); }
 
+     private:
         Result<T> result;
     };
 
-    struct SendAwaiter : Awaitable {
+    struct ReceiveManyAwaiter : Consumer {
      public:
-        SendAwaiter(MPMCChannel* self, T* value, CancellationSlot slot)
-            : Awaitable(self, slot)
-            , value{value} {}
-
-        bool await_ready() const {
-            if (self->buf_.empty() && !self->parked_.empty()) {
-                auto* receiver = static_cast<ReceiveAwaiter*>(self->parked_.popFront());
-                receiver->resume(value);
-                return true;
-            }
+        ReceiveManyAwaiter(
+            MPMCChannel* self, CancellationSlot slot, std::span<T> out, size_t min, size_t max)
+            : Consumer(self, slot, out.first(max), min) {}
 
-            if (!self->buf_.full()) {
-                self->buf_.push(std::move(*value));
-                return true;
-            }
+        size_t await_resume() const { return this->count; }
+    };
 
-            // buffer is filled and there is no awaiting receiver: park
-            return false;
+    struct SendAwaiter : Producer {
+     public:
+        SendAwaiter(MPMCChannel* self, CancellationSlot slot, T* value)
+            : Producer(self, slot, {value, 1}) {}
+
+        Result<Unit> await_resume() const {
+            return this->drained() ? ok() : err<Unit>(ErrCode::Cancelled);
         }
+    };
 
-        void await_suspend(std::coroutine_handle<> a_caller) {
-            caller = a_caller;
-            slot.installIfConnected(this);
-            self->parked_.pushBack(this);
+    template <typename... Args>
+    struct EmplaceAwaiter : Producer {
+     public:
+        EmplaceAwaiter(MPMCChannel* self, CancellationSlot slot, std::tuple<Args...> args)
+            : Producer(self, slot, {reinterpret_cast<T*>(value_), 1})
+            , args{std::move(args)} {}
+
+        ~EmplaceAwaiter() {
+            if (constructed) {
+                value().~T();
+            }
         }
 
         Result<Unit> await_resume() const {
-            // cancel() zeroes the self pointer
-            return self == nullptr ? err<Unit>(ErrCode::Cancelled) : ok();
+            return this->drained() ? ok() : err<Unit>(ErrCode::Cancelled);
         }
 
-        void resume() {
-            slot.clearIfConnected();
-            self->buf_.push(std::move(*value));
-            caller.resume();
+     private:
+        // the value is constructed only once there is room for it
+        void prepare() override {
+            std::apply([this](auto&&... a) { new (value_) T(std::move(a)...); }, std::move(args));
+            constructed = true;
         }
 
-     private:
-        using Awaitable::caller;
-        using Awaitable::self;
-        using Awaitable::slot;
+        T& value() { return *std::launder(reinterpret_cast<T*>(value_)); }
 
-        T* value;
+        std::tuple<Args...> args;
+        alignas(T) uint8_t value_[sizeof(T)] /* uninitialized */;
+        bool constructed = false;
     };
 
-    struct Receive : supp::NonCopyable {
+    struct SendManyAwaiter : Producer {
      public:
-        Receive(MPMCChannel* self) : self_{self} {}
-        Receive(Receive&&) = default;
+        SendManyAwaiter(MPMCChannel* self, CancellationSlot slot, std::span<T> values)
+            : Producer(self, slot, values) {}
+
+        size_t await_resume() const { return this->sent; }
+    };
+
+    template <typename A, typename... Args>
+    struct [[nodiscard]] Operation : supp::NonCopyable {
+     public:
+        // receive() takes its value while resuming the receiver, see Selectable
+        static constexpr bool HandsOverInline = std::same_as<A, ReceiveAwaiter>;
+
+        Operation(MPMCChannel* self, Args... args) : self_{self}, args_{std::move(args)...} {}
+        Operation(Operation&&) = default;
 
         // CancellableAwaitable
-        Receive& setCancellationSlot(CancellationSlot slot) {
+        Operation& setCancellationSlot(CancellationSlot slot) {
             slot_ = slot;
             return *this;
         }
 
-        auto operator co_await() { return ReceiveAwaiter{self_, slot_}; }
+        A operator co_await() {
+            return std::apply(
+                [this](auto&&... args) { return A{self_, slot_, std::move(args)...}; },
+                std::move(args_));
+        }
 
      private:
         MPMCChannel* self_;
+        std::tuple<Args...> args_;
         CancellationSlot slot_{};
     };
 
-    struct Send : supp::NonCopyable {
-     public:
-        Send(MPMCChannel* self, T* value) : self_{self}, value{value} {}
-        Send(Send&&) = default;
+    // Returns true if the producer has been drained.
+    bool push(Producer* producer) {
+        supp::IntrusiveList<Awaiter> ready;
 
-        // CancellableAwaitable
-        Send& setCancellationSlot(CancellationSlot slot) {
-            slot_ = slot;
-            return *this;
+        // the buffer is empty if there are parked receivers
+        while (!producer->drained() && !receivers_.empty()) {
+            auto* receiver = receivers_.front();
+            receiver->give(producer->take(receiver->room()));
+
+            if (!receiver->satisfied()) {
+                break;
+            }
+
+            receivers_.popFront();
+            ready.pushBack(receiver);
         }
 
-        auto operator co_await() { return SendAwaiter{self_, value, slot_}; }
+        fill(producer);
 
-     private:
-        MPMCChannel* self_;
-        T* value;
-        CancellationSlot slot_{};
-    };
+        wakeAll(ready);
+        return producer->drained();
+    }
+
+    // Returns true if the consumer has been satisfied.
+    bool pull(Consumer* consumer) {
+        supp::IntrusiveList<Awaiter> ready;
+
+        while (!consumer->full() && !buf_.empty()) {
+            consumer->give(buf_.pop());
+        }
+
+        // the buffer is empty now, values of parked senders go next
+        while (!consumer->full() && !senders_.empty()) {
+            auto* sender = senders_.front();
+            consumer->give(sender->take(consumer->room()));
+
+            if (sender->drained()) {
+                senders_.popFront();
+                ready.pushBack(sender);
+            }
+        }
+
+        // refill the buffer from parked senders
+        while (!buf_.full() && !senders_.empty()) {
+            auto* sender = senders_.front();
+            fill(sender);
+
+            if (sender->drained()) {
+                senders_.popFront();
+                ready.pushBack(sender);
+            }
+        }
+
+        wakeAll(ready);
+        return consumer->satisfied();
+    }
+
+    // Moves as many values of the producer into the buffer as there is room for
+    void fill(Producer* producer) {
+        for (auto& value : producer->take(Capacity - buf_.size())) {
+            buf_.push(std::move(value));
+        }
+    }
+
+    static void wakeAll(supp::IntrusiveList<Awaiter>& ready) {
+        while (!ready.empty()) {
+            ready.popFront()->wake();
+        }
+    }
 
     supp::CircularBuffer<T, Capacity> buf_;
-    supp::IntrusiveList<Awaitable> parked_;
+    supp::IntrusiveList<Producer> senders_;
+    supp::IntrusiveList<Consumer> receivers_;
 };
 
 }  // namespace exec
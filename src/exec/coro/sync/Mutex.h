@@ -1,39 +1,85 @@
 #pragma once
 
+#include "exec/Runnable.h"
 #include "exec/coro/cancel.h"
 #include "exec/coro/traits.h"
+#include "exec/executor/Executor.h"
+#include "exec/os/Service.h"
 
 #include <supp/IntrusiveList.h>
 #include <supp/NonCopyable.h>
 #include <supp/Pinned.h>
 
 #include <coroutine>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
 
 namespace exec {
 
-class Mutex;
+class ConditionVariable;
 
-class [[nodiscard]] LockGuard {
+enum class MutexPolicy : uint8_t {
+    // unlock() passes the lock to the first waiter and resumes it right away
+    Handoff,
+
+    // unlock() frees the lock and schedules the first waiter on the Executor,
+    // a running coroutine may take the lock before the waiter gets to run
+    Barging,
+};
+
+template <class M>
+class [[nodiscard]] BasicLockGuard {
  public:
-    LockGuard() = default;
-    ~LockGuard();
+    BasicLockGuard() = default;
+
+    ~BasicLockGuard() {
+        if (self_ != nullptr) {
+            self_->unlock();
+        }
+    }
+
+    BasicLockGuard(BasicLockGuard&& r) noexcept : self_{std::exchange(r.self_, nullptr)} {}
+
+    BasicLockGuard& operator=(BasicLockGuard&& r) noexcept {
+        if (this == &r) {
+            return *this;
+        }
+
+        if (self_ != nullptr) {
+            self_->unlock();
+        }
+
+        self_ = std::exchange(r.self_, nullptr);
+        return *this;
+    }
 
-    LockGuard(LockGuard&& r) noexcept : self_{std::exchange(r.self_, nullptr)} {}
-    LockGuard& operator=(LockGuard&& r) noexcept;
+    void unlock() && {
+        if (self_ != nullptr) {
+            std::exchange(self_, nullptr)->unlock();
+        }
+    }
 
-    void unlock() &&;
     explicit operator bool() const { return self_ != nullptr; }
 
  private:
-    LockGuard(Mutex* self) : self_{self} {}
+    BasicLockGuard(M* self) : self_{self} {}
 
-    Mutex* self_ = nullptr;
-    friend class Mutex;
+    M* self_ = nullptr;
+    friend M;
+    friend class ConditionVariable;
 };
 
-class Mutex : supp::Pinned {
+// With MutexPolicy::Barging, a waiter that has lost the lock MaxBarges times in a row
+// gets it handed over directly.
+template <MutexPolicy Policy = MutexPolicy::Handoff, uint8_t MaxBarges = 4>
+class BasicMutex : supp::Pinned {
+    static constexpr bool Barging = Policy == MutexPolicy::Barging;
+
  public:
-    Mutex() = default;
+    using LockGuard = BasicLockGuard<BasicMutex>;
+
+    BasicMutex() = default;
 
     LockGuard try_lock() {
         if (tryLockRaw()) {
@@ -47,7 +93,7 @@ class Mutex : supp::Pinned {
 
  private:
     struct Awaiter : CancellationHandler, supp::IntrusiveListNode {
-        Awaiter(Mutex* self, CancellationSlot slot) : self_{self}, slot_{slot} {}
+        Awaiter(BasicMutex* self, CancellationSlot slot) : self_{self}, slot_{slot} {}
 
         bool await_ready() { return self_->tryLockRaw(); }
 
@@ -72,15 +118,65 @@ class Mutex : supp::Pinned {
             caller_.resume();
         }
 
-     private:
-        Mutex* self_;
+     protected:
+        BasicMutex* self_;
         CancellationSlot slot_;
         std::coroutine_handle<> caller_;
+
+        friend class BasicMutex;
     };
 
+    // Scheduled on the Executor by unlock() to try to take the lock
+    struct BargingAwaiter : Awaiter, Runnable {
+        using Awaiter::Awaiter;
+
+        // CancellationHandler
+        std::coroutine_handle<> cancel() override {
+            if (scheduled_) {
+                // cannot be taken out of the executor's queue, completed by run()
+                cancelled_ = true;
+                return std::noop_coroutine();
+            }
+
+            return Awaiter::cancel();
+        }
+
+        // Runnable
+        void run() override {
+            auto* self = this->self_;
+            scheduled_ = false;
+            self->barging_.waking = false;
+
+            if (cancelled_) {
+                self->wakeFirst();
+                this->self_ = nullptr;
+                this->caller_.resume();
+                return;
+            }
+
+            if (self->tryLockRaw()) {
+                self->barging_.barges = 0;
+                this->takeLock();
+                return;
+            }
+
+            // a running coroutine has taken the lock first, stays the first in line
+            ++self->barging_.barges;
+            self->parked_.pushFront(this);
+        }
+
+        bool scheduled_ = false;
+        bool cancelled_ = false;
+    };
+
+    using Waiter = std::conditional_t<Barging, BargingAwaiter, Awaiter>;
+
     struct [[nodiscard]] Awaitable : supp::NonCopyable {
      public:
-        Awaitable(Mutex* self) : self_{self} {}
+        // the lock is handed over while resuming the waiter, see Selectable
+        static constexpr bool HandsOverInline = true;
+
+        Awaitable(BasicMutex* self) : self_{self} {}
 
         // CancellableAwaitable
         Awaitable& setCancellationSlot(CancellationSlot slot) {
@@ -88,10 +184,10 @@ class Mutex : supp::Pinned {
             return *this;
         }
 
-        Awaiter operator co_await() { return Awaiter{self_, slot_}; }
+        Waiter operator co_await() { return Waiter{self_, slot_}; }
 
      private:
-        Mutex* self_;
+        BasicMutex* self_;
         CancellationSlot slot_{};
     };
 
@@ -104,6 +200,17 @@ class Mutex : supp::Pinned {
         return true;
     }
 
+    // Returns true if the lock has been taken, otherwise the waiter is parked
+    // and gets the lock from unlock().
+    bool lockOrPark(Awaiter* awaiter) {
+        if (tryLockRaw()) {
+            return true;
+        }
+
+        parked_.pushBack(awaiter);
+        return false;
+    }
+
     void unlock() {
         DASSERT(locked_);
 
@@ -112,38 +219,49 @@ class Mutex : supp::Pinned {
             return;
         }
 
+        if constexpr (Barging) {
+            if (barging_.barges < MaxBarges) {
+                locked_ = false;
+                wakeFirst();
+                return;
+            }
+
+            barging_.barges = 0;
+        }
+
         parked_.popFront()->takeLock();
     }
 
+    // Schedules the first waiter to try to take the lock, one at a time
+    void wakeFirst() requires Barging {
+        if (barging_.waking || locked_ || parked_.empty()) {
+            return;
+        }
+
+        barging_.waking = true;
+        // only BargingAwaiters park on a barging mutex
+        auto* awaiter = static_cast<BargingAwaiter*>(parked_.popFront());
+        awaiter->scheduled_ = true;
+        service<Executor>()->post(awaiter);
+    }
+
     supp::IntrusiveList<Awaiter> parked_;
     bool locked_ = false;
 
-    friend class LockGuard;
-};
-
-LockGuard::~LockGuard() {
-    if (self_ != nullptr) {
-        self_->unlock();
-    }
-}
+    struct BargingState {
+        uint8_t barges = 0;  // times the first waiter has lost the lock
+        bool waking = false;
+    };
 
-void LockGuard::unlock() && {
-    if (self_ != nullptr) {
-        std::exchange(self_, nullptr)->unlock();
-    }
-}
+    struct NoState {};
 
-LockGuard& LockGuard::operator=(LockGuard&& r) noexcept {
-    if (this == &r) {
-        return *this;
-    }
+    [[no_unique_address]] std::conditional_t<Barging, BargingState, NoState> barging_;
 
-    if (self_ != nullptr) {
-        self_->unlock();
-    }
+    friend LockGuard;
+    friend class ConditionVariable;
+};
 
-    self_ = std::exchange(r.self_, nullptr);
-    return *this;
-}
+using Mutex = BasicMutex<>;
+using LockGuard = Mutex::LockGuard;
 
 }  // namespace exec
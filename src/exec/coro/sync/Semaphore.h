@@ -8,38 +8,42 @@
 #include <supp/NonCopyable.h>
 
 #include <coroutine>
+#include <utility>
 
 namespace exec {
 
+// Counting semaphore, units may be acquired and released in batches.
+// Waiters are served in FIFO order: a request that does not fit holds back the ones behind it.
 class Semaphore : supp::NonCopyable {
  public:
     explicit Semaphore(int init) : counter_{init} {}
 
-    bool tryAcquire() {
-        if (counter_ == 0) {
+    bool tryAcquire(int n = 1) {
+        DASSERT(n > 0);
+
+        if (!parked_.empty() || counter_ < n) {
             return false;
         }
 
-        --counter_;
+        counter_ -= n;
         return true;
     }
 
-    CancellableAwaitable auto acquire() { return Awaitable{this}; }
+    CancellableAwaitable auto acquire(int n = 1) { return Awaitable{this, n}; }
 
-    void release() {
-        if (counter_++ != 0 || parked_.empty()) {
-            return;
-        }
+    // Resumes all parked waiters whose requests fit now
+    void release(int n = 1) {
+        DASSERT(n > 0);
 
-        --counter_;
-        parked_.popFront()->takeSemaphore();
+        counter_ += n;
+        admit();
     }
 
  private:
     struct Awaiter : CancellationHandler, supp::IntrusiveListNode {
-        explicit Awaiter(Semaphore* self, CancellationSlot slot) : self_{self}, slot_{slot} {}
+        Awaiter(Semaphore* self, CancellationSlot slot, int n) : self_{self}, slot_{slot}, n_{n} {}
 
-        bool await_ready() { return self_->tryAcquire(); }
+        bool await_ready() { return self_->tryAcquire(n_); }
 
         void await_suspend(std::coroutine_handle<> caller) {
             slot_.installIfConnected(this);
@@ -54,7 +58,8 @@ class Semaphore : supp::NonCopyable {
         // CancellationHandler
         std::coroutine_handle<> cancel() override {
             unlink();
-            self_ = nullptr;
+            // waiters behind a big request may fit now
+            std::exchange(self_, nullptr)->admit();
             return caller_;
         }
 
@@ -65,12 +70,13 @@ class Semaphore : supp::NonCopyable {
 
         Semaphore* self_;
         CancellationSlot slot_;
+        const int n_;
         std::coroutine_handle<> caller_;
     };
 
     struct [[nodiscard]] Awaitable : supp::NonCopyable {
      public:
-        Awaitable(Semaphore* self) : self_{self} {}
+        Awaitable(Semaphore* self, int n) : self_{self}, n_{n} {}
 
         // CancellableAwaitable
         Awaitable& setCancellationSlot(CancellationSlot slot) {
@@ -78,13 +84,26 @@ class Semaphore : supp::NonCopyable {
             return *this;
         }
 
-        Awaiter operator co_await() { return Awaiter{self_, slot_}; }
+        Awaiter operator co_await() { return Awaiter{self_, slot_, n_}; }
 
      private:
         Semaphore* self_;
+        int n_;
         CancellationSlot slot_{};
     };
 
+    void admit() {
+        supp::IntrusiveList<Awaiter> admitted;
+        while (!parked_.empty() && parked_.front()->n_ <= counter_) {
+            counter_ -= parked_.front()->n_;
+            admitted.pushBack(parked_.popFront());
+        }
+
+        while (!admitted.empty()) {
+            admitted.popFront()->takeSemaphore();
+        }
+    }
+
     supp::IntrusiveList<Awaiter> parked_;
     int counter_ = 0;
 };
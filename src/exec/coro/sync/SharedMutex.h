@@ -0,0 +1,198 @@
+#pragma once
+
+#include "exec/coro/cancel.h"
+#include "exec/coro/traits.h"
+
+#include <supp/IntrusiveList.h>
+#include <supp/NonCopyable.h>
+#include <supp/Pinned.h>
+
+#include <coroutine>
+#include <cstdint>
+#include <utility>
+
+namespace exec {
+
+class SharedMutex;
+
+class [[nodiscard]] SharedLockGuard {
+ public:
+    SharedLockGuard() = default;
+    ~SharedLockGuard() { std::move(*this).unlock(); }
+
+    SharedLockGuard(SharedLockGuard&& r) noexcept
+        : self_{std::exchange(r.self_, nullptr)}
+        , shared_{r.shared_} {}
+
+    SharedLockGuard& operator=(SharedLockGuard&& r) noexcept {
+        if (this != &r) {
+            std::move(*this).unlock();
+            self_ = std::exchange(r.self_, nullptr);
+            shared_ = r.shared_;
+        }
+
+        return *this;
+    }
+
+    inline void unlock() &&;
+    explicit operator bool() const { return self_ != nullptr; }
+
+ private:
+    SharedLockGuard(SharedMutex* self, bool shared) : self_{self}, shared_{shared} {}
+
+    SharedMutex* self_ = nullptr;
+    bool shared_ = false;
+
+    friend class SharedMutex;
+};
+
+// Readers share the lock, writers own it exclusively.
+// Waiters are served in FIFO order, so readers arriving after a parked writer wait for it:
+// writers do not starve. Releasing the lock to readers admits all of them parked in a row.
+class SharedMutex : supp::Pinned {
+ public:
+    SharedMutex() = default;
+
+    SharedLockGuard try_lock() { return SharedLockGuard{tryLockRaw(false) ? this : nullptr, false}; }
+
+    SharedLockGuard try_lock_shared() {
+        return SharedLockGuard{tryLockRaw(true) ? this : nullptr, true};
+    }
+
+    CancellableAwaitable auto lock() { return Awaitable{this, false}; }
+    CancellableAwaitable auto lockShared() { return Awaitable{this, true}; }
+
+ private:
+    struct Awaiter : CancellationHandler, supp::IntrusiveListNode {
+        Awaiter(SharedMutex* self, CancellationSlot slot, bool shared)
+            : self_{self}
+            , slot_{slot}
+            , shared_{shared} {}
+
+        bool await_ready() { return self_->tryLockRaw(shared_); }
+
+        // Locked, should park
+        void await_suspend(std::coroutine_handle<> caller) {
+            slot_.installIfConnected(this);
+            caller_ = caller;
+            self_->parked_.pushBack(this);
+        }
+
+        auto await_resume() const { return SharedLockGuard{self_, shared_}; }
+
+        // CancellationHandler
+        std::coroutine_handle<> cancel() override {
+            unlink();
+            // readers parked behind a cancelled writer may be able to proceed
+            self_->admitReaders();
+            self_ = nullptr;
+            return caller_;
+        }
+
+        void takeLock() {
+            slot_.clearIfConnected();
+            caller_.resume();
+        }
+
+        bool shared() const { return shared_; }
+
+     private:
+        SharedMutex* self_;
+        CancellationSlot slot_;
+        const bool shared_;
+        std::coroutine_handle<> caller_;
+    };
+
+    struct [[nodiscard]] Awaitable : supp::NonCopyable {
+     public:
+        // the lock is handed over while resuming the waiter, see Selectable
+        static constexpr bool HandsOverInline = true;
+
+        Awaitable(SharedMutex* self, bool shared) : self_{self}, shared_{shared} {}
+
+        // CancellableAwaitable
+        Awaitable& setCancellationSlot(CancellationSlot slot) {
+            slot_ = slot;
+            return *this;
+        }
+
+        Awaiter operator co_await() { return Awaiter{self_, slot_, shared_}; }
+
+     private:
+        SharedMutex* self_;
+        bool shared_;
+        CancellationSlot slot_{};
+    };
+
+    bool tryLockRaw(bool shared) {
+        // anybody parked means the lock is not available in its current mode
+        if (writer_ || !parked_.empty()) {
+            return false;
+        }
+
+        if (shared) {
+            ++readers_;
+            return true;
+        }
+
+        if (readers_ > 0) {
+            return false;
+        }
+
+        writer_ = true;
+        return true;
+    }
+
+    void unlock(bool shared) {
+        if (shared) {
+            DASSERT(readers_ > 0);
+            --readers_;
+        } else {
+            DASSERT(writer_);
+            writer_ = false;
+        }
+
+        if (readers_ > 0 || parked_.empty()) {
+            return;
+        }
+
+        if (!parked_.front()->shared()) {
+            writer_ = true;
+            parked_.popFront()->takeLock();
+            return;
+        }
+
+        admitReaders();
+    }
+
+    // Hands the lock over to all readers parked at the front at once
+    void admitReaders() {
+        if (writer_) {
+            return;
+        }
+
+        supp::IntrusiveList<Awaiter> admitted;
+        while (!parked_.empty() && parked_.front()->shared()) {
+            ++readers_;
+            admitted.pushBack(parked_.popFront());
+        }
+
+        while (!admitted.empty()) {
+            admitted.popFront()->takeLock();
+        }
+    }
+
+    supp::IntrusiveList<Awaiter> parked_;
+    uint16_t readers_ = 0;
+    bool writer_ = false;
+
+    friend class SharedLockGuard;
+};
+
+void SharedLockGuard::unlock() && {
+    if (self_ != nullptr) {
+        std::exchange(self_, nullptr)->unlock(shared_);
+    }
+}
+
+}  // namespace exec
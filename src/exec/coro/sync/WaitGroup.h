@@ -0,0 +1,102 @@
+#pragma once
+
+#include "exec/Error.h"
+#include "exec/coro/cancel.h"
+#include "exec/coro/traits.h"
+
+#include <supp/IntrusiveList.h>
+#include <supp/NonCopyable.h>
+#include <supp/Pinned.h>
+
+#include <coroutine>
+#include <cstddef>
+
+namespace exec {
+
+// Counts outstanding work: add() before starting it, done() when it has finished.
+// wait() completes when nothing is outstanding. Unlike Latch, it can be reused.
+class WaitGroup : supp::Pinned {
+ public:
+    WaitGroup() = default;
+
+    ~WaitGroup() { DASSERT(parked_.empty(), F("destroyed with parked waiters")); }
+
+    size_t count() const { return count_; }
+
+    void add(size_t n = 1) { count_ += n; }
+
+    void done() {
+        DASSERT(count_ > 0);
+
+        if (--count_ == 0) {
+            releaseAll();
+        }
+    }
+
+    CancellableAwaitable auto wait() { return Awaitable{this}; }
+
+ private:
+    struct Awaiter : CancellationHandler, supp::IntrusiveListNode {
+     public:
+        Awaiter(WaitGroup* self, CancellationSlot slot) : self_{self}, slot_{slot} {}
+
+        bool await_ready() const { return self_->count_ == 0; }
+
+        void await_suspend(std::coroutine_handle<> caller) {
+            slot_.installIfConnected(this);
+            caller_ = caller;
+            self_->parked_.pushBack(this);
+        }
+
+        ErrCode await_resume() const {
+            return self_ == nullptr ? ErrCode::Cancelled : ErrCode::Success;
+        }
+
+        // CancellationHandler
+        std::coroutine_handle<> cancel() override {
+            unlink();
+            self_ = nullptr;
+            return caller_;
+        }
+
+        void released() {
+            slot_.clearIfConnected();
+            caller_.resume();
+        }
+
+     private:
+        WaitGroup* self_;
+        CancellationSlot slot_;
+        std::coroutine_handle<> caller_ = nullptr;
+    };
+
+    struct [[nodiscard]] Awaitable : supp::NonCopyable {
+        Awaitable(WaitGroup* self) : self_{self} {}
+
+        // CancellableAwaitable
+        Awaitable& setCancellationSlot(CancellationSlot slot) {
+            slot_ = slot;
+            return *this;
+        }
+
+        Awaiter operator co_await() { return Awaiter{self_, slot_}; }
+
+     private:
+        WaitGroup* self_;
+        CancellationSlot slot_;
+    };
+
+    void releaseAll() {
+        // waiters added while releasing wait for the next round
+        auto parked(std::move(parked_));
+
+        while (!parked.empty()) {
+            parked.popFront()->released();
+        }
+    }
+
+    supp::IntrusiveList<Awaiter> parked_;
+    size_t count_ = 0;
+};
+
+}  // namespace exec
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "exec/Error.h"
+#include "exec/result/Result.h"
+#include "exec/coro/cancel.h"
+#include "exec/coro/traits.h"
+
+#include <supp/IntrusiveList.h>
+#include <supp/NonCopyable.h>
+#include <supp/Pinned.h>
+
+#include <coroutine>
+#include <cstdint>
+#include <utility>
+
+namespace exec {
+
+// Holds the latest value and wakes up all readers when it changes.
+// Readers remember the last version they have seen and read the value via get(),
+// intermediate values may be skipped by slow readers.
+template <typename T>
+class Watch : supp::Pinned {
+ public:
+    using Version = uint32_t;
+
+    // Version 0 means that no value has been set yet
+    Watch() = default;
+    explicit Watch(T value) : value_{std::move(value)}, version_{1} {}
+
+    const T& get() const { return value_; }
+    Version version() const { return version_; }
+
+    void set(T value) {
+        value_ = std::move(value);
+        changed();
+    }
+
+    // Modifies the value in place: f(T&)
+    template <typename F>
+    void update(F&& f) {
+        std::forward<F>(f)(value_);
+        changed();
+    }
+
+    // Resumes once the version differs from lastSeen.
+    // Returns the current version.
+    CancellableAwaitable auto changed(Version lastSeen) { return Awaitable{this, lastSeen}; }
+
+ private:
+    struct Awaiter : CancellationHandler, supp::IntrusiveListNode {
+     public:
+        Awaiter(Watch* self, CancellationSlot slot, Version lastSeen)
+            : self_{self}
+            , slot_{slot}
+            , lastSeen_{lastSeen} {}
+
+        bool await_ready() const { return self_->version_ != lastSeen_; }
+
+        void await_suspend(std::coroutine_handle<> caller) {
+            slot_.installIfConnected(this);
+            caller_ = caller;
+            self_->parked_.pushBack(this);
+        }
+
+        Result<Version> await_resume() const {
+            return self_ == nullptr ? err<Version>(ErrCode::Cancelled) : self_->version_;
+        }
+
+        // CancellationHandler
+        std::coroutine_handle<> cancel() override {
+            unlink();
+            self_ = nullptr;
+            return caller_;
+        }
+
+        void changed() {
+            slot_.clearIfConnected();
+            caller_.resume();
+        }
+
+     private:
+        Watch* self_;
+        CancellationSlot slot_;
+        Version lastSeen_;
+        std::coroutine_handle<> caller_ = nullptr;
+    };
+
+    struct [[nodiscard]] Awaitable : supp::NonCopyable {
+        // the version is handed over while resuming the waiter, see Selectable
+        static constexpr bool HandsOverInline = true;
+
+        Awaitable(Watch* self, Version lastSeen) : self_{self}, lastSeen_{lastSeen} {}
+
+        // CancellableAwaitable
+        Awaitable& setCancellationSlot(CancellationSlot slot) {
+            slot_ = slot;
+            return *this;
+        }
+
+        Awaiter operator co_await() { return Awaiter{self_, slot_, lastSeen_}; }
+
+     private:
+        Watch* self_;
+        Version lastSeen_;
+        CancellationSlot slot_;
+    };
+
+    void changed() {
+        // readers parked while waking up the current ones wait for the next version
+        auto parked(std::move(parked_));
+
+        ++version_;
+        while (!parked.empty()) {
+            parked.popFront()->changed();
+        }
+    }
+
+    T value_{};
+    Version version_ = 0;
+    supp::IntrusiveList<Awaiter> parked_;
+};
+
+}  // namespace exec
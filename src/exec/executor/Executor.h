@@ -8,6 +8,11 @@ class Executor {
  public:
     virtual ~Executor() = default;
     virtual void post(Runnable* r) = 0;
+
+    // Takes a posted runnable back, false when it is already running or not queued.
+    // Executors that cannot take runnables back keep the default, the runnable then runs
+    // as posted and cancelling a wait on it completes only then.
+    [[nodiscard]] virtual bool remove(Runnable* /*r*/) { return false; }
 };
 
 }  // namespace exec
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <bit>
+#include <cinttypes>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+namespace exec {
+
+// Counts of durations in power of two buckets:
+// bucket 0 holds 0us, bucket i holds [2^(i-1), 2^i) us, the last one everything above.
+struct Log2Histogram {
+    static constexpr size_t Buckets = 24;
+
+    void add(uint32_t us) {
+        const size_t i = std::bit_width(us);
+        ++counts[i < Buckets ? i : Buckets - 1];
+    }
+
+    // Upper bound of the bucket in microseconds, exclusive
+    static uint32_t bound(size_t bucket) { return uint32_t(1) << bucket; }
+
+    // Calls print(const char* line) with the non-empty buckets as "<bound>us:<count>" pairs
+    template <typename F>
+    void print(const char* title, F&& print) const {
+        char line[96];
+        int n = std::snprintf(line, sizeof(line), "%s", title);
+
+        for (size_t i = 0; i < Buckets; ++i) {
+            if (counts[i] == 0) {
+                continue;
+            }
+
+            if (n > int(sizeof(line)) - 24) {
+                print(static_cast<const char*>(line));
+                n = std::snprintf(line, sizeof(line), "%s", title);
+            }
+
+            const char* op = i + 1 < Buckets ? "<" : ">=";
+            const uint32_t b = i + 1 < Buckets ? bound(i) : bound(i - 1);
+            n += std::snprintf(line + n, sizeof(line) - n, " %s%" PRIu32 "us:%" PRIu32, op, b,
+                counts[i]);
+        }
+
+        print(static_cast<const char*>(line));
+    }
+
+    uint32_t counts[Buckets]{};
+};
+
+// Queue measurements of SystemExecutor, collected with EXEC_PROFILE enabled.
+struct ExecutorStats {
+    Log2Histogram wait;  // from post() to run()
+    Log2Histogram run;   // duration of run()
+
+    uint32_t runs = 0;
+    uint16_t depth = 0;        // runnables queued now
+    uint16_t maxDepth = 0;     // high-water mark
+    uint16_t lastDrained = 0;  // runnables run by the last tick
+    uint16_t maxDrained = 0;
+
+    void posted() {
+        ++depth;
+        maxDepth = depth > maxDepth ? depth : maxDepth;
+    }
+
+    void ran(uint32_t waitUs, uint32_t runUs) {
+        --depth;
+        ++runs;
+        wait.add(waitUs);
+        run.add(runUs);
+    }
+
+    void removed() { --depth; }
+
+    void drained(uint16_t count) {
+        lastDrained = count;
+        maxDrained = count > maxDrained ? count : maxDrained;
+    }
+
+    // Calls print(const char* line) a few times
+    template <typename F>
+    void print(F&& print) const {
+        char line[96];
+        std::snprintf(line, sizeof(line),
+            "runs=%" PRIu32 " depth=%u max=%u drained last=%u max=%u", runs, unsigned(depth),
+            unsigned(maxDepth), unsigned(lastDrained), unsigned(maxDrained));
+        print(static_cast<const char*>(line));
+        wait.print("wait", print);
+        run.print("run", print);
+    }
+};
+
+}  // namespace exec
@@ -2,33 +2,113 @@
 
 #include "exec/executor/Executor.h"
 #include "exec/os/ServiceBase.h"
+#include "exec/trace/trace.h"
+
+#if EXEC_PROFILE
+#include "exec/executor/ExecutorStats.h"
+#include "exec/os/clock.h"
+#endif
 
 #include <supp/IntrusiveForwardList.h>
 #include <time/mono.h>
 
+#include <utility>
+
 namespace exec {
 
 class SystemExecutor : public Executor, public ServiceBase<Executor, SystemExecutor> {
  public:
-    void post(Runnable* r) override { queue_.pushBack(r); }
+    void post(Runnable* r) override {
+        trace::record(trace::Event::Post, r);
+#if EXEC_PROFILE
+        r->postedAt_ = nowMicros();
+        stats_.posted();
+#endif
+        queue_.pushBack(r);
+    }
+
+    // Linear in the position of the runnable, the queue is walked up to it.
+    // Runnables taken for the current tick can be removed until they run.
+    bool remove(Runnable* r) override {
+        const bool removed = (taken_ != nullptr && unlink(*taken_, r)) || unlink(queue_, r);
+
+#if EXEC_PROFILE
+        if (removed) {
+            stats_.removed();
+        }
+#endif
+        return removed;
+    }
 
     // Service
     void tick() override {
-        auto q = std::move(queue_);
+        Queue q = std::move(queue_);
+        auto* outer = std::exchange(taken_, &q);
+
+#if EXEC_PROFILE
+        uint16_t drained = 0;
+#endif
 
         while (!q.empty()) {
-            q.popFront()->run();
+            auto* r = q.popFront();
+            trace::record(trace::Event::Run, r);
+#if EXEC_PROFILE
+            const uint32_t start = nowMicros();
+            const uint32_t wait = start - r->postedAt_;
+            ++drained;
+            r->run();  // may destroy r
+            stats_.ran(wait, nowMicros() - start);
+#else
+            r->run();
+#endif
         }
 
-        queue_.prepend(std::move(q));
+        taken_ = outer;
+#if EXEC_PROFILE
+        stats_.drained(drained);
+#endif
     }
 
     ttime::Time wakeAt() const override {
         return queue_.empty() ? ttime::Time::max() : ttime::mono::now();
     }
 
+#if EXEC_PROFILE
+    const ExecutorStats& stats() const { return stats_; }
+
+    void resetStats() {
+        const uint16_t depth = stats_.depth;
+        stats_ = ExecutorStats{};
+        stats_.depth = depth;
+    }
+#endif
+
  private:
-    supp::IntrusiveForwardList<Runnable> queue_;
+    using Queue = supp::IntrusiveForwardList<Runnable>;
+
+    // Takes r out of the queue keeping the order of the others
+    static bool unlink(Queue& queue, Runnable* r) {
+        Queue before;
+        bool found = false;
+
+        while (!queue.empty() && !found) {
+            auto* queued = queue.popFront();
+            if (queued == r) {
+                found = true;
+            } else {
+                before.pushBack(queued);
+            }
+        }
+
+        queue.prepend(std::move(before));
+        return found;
+    }
+
+    Queue queue_;
+    Queue* taken_ = nullptr;  // runnables taken for the current tick
+#if EXEC_PROFILE
+    ExecutorStats stats_;
+#endif
 };
 
 }  // namespace exec
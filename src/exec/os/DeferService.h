@@ -3,30 +3,53 @@
 #include "exec/Runnable.h"
 #include "exec/os/ServiceBase.h"
 
-#include <supp/PriorityQueue.h>
+#include <supp/RandomAccessPriorityQueue.h>
 
 #include <time/mono.h>
 
 namespace exec {
 
+struct DeferEntry : Runnable, supp::RandomAccessPriorityQueueNode {
+    ttime::Time at;
+};
+
 class DeferService {
  public:
     virtual ~DeferService() = default;
-    [[nodiscard]] virtual bool defer(Runnable* r, ttime::Time at) = 0;
+
+    // Services overriding only this one defer entries as plain runnables.
+    [[nodiscard]] virtual bool defer(Runnable* /*r*/, ttime::Time /*at*/) { return false; }
+
+    [[nodiscard]] virtual bool defer(DeferEntry* e, ttime::Time at) {
+        return defer(static_cast<Runnable*>(e), at);
+    }
+
+    // false when the entry has already run, is not deferred or cannot be taken back,
+    // the entry then runs as deferred
+    [[nodiscard]] virtual bool cancel(DeferEntry* /*e*/) { return false; }
 };
 
 template <int MaxDefers>
 class HeapDeferService : public DeferService,
                          public ServiceBase<DeferService, HeapDeferService<MaxDefers>> {
  public:
-    bool defer(Runnable* r, ttime::Time at) override { return heap_.push(Defer{at, r}); }
+    // Takes only DeferEntry, the plain Runnable overload refuses
+    using DeferService::defer;
+
+    bool defer(DeferEntry* e, ttime::Time at) override {
+        DASSERT(!e->connected());
+        e->at = at;
+        return heap_.push(e);
+    }
+
+    bool cancel(DeferEntry* e) override { return heap_.erase(e); }
 
     // Service
     void tick() override {
         auto now = ttime::mono::now();
 
-        while (!heap_.empty() && now >= heap_.front().at) {
-            heap_.pop().task->run();
+        while (!heap_.empty() && now >= heap_.front()->at) {
+            heap_.pop()->run();
         }
     }
 
@@ -35,17 +58,14 @@ class HeapDeferService : public DeferService,
             return ttime::Time::max();
         }
 
-        return heap_.front().at;
+        return heap_.front()->at;
     }
 
- private:
-    struct Defer {  // NOLINT
-        ttime::Time at;
-        Runnable* task;
-    };
+    size_t size() const { return heap_.size(); }
 
+ private:
     using Comp = decltype([](auto& l, auto& r) { return l.at < r.at; });
-    supp::PriorityQueue<Defer, MaxDefers, Comp> heap_;
+    supp::RandomAccessPriorityQueue<DeferEntry, MaxDefers, Comp> heap_;
 };
 
 }  // namespace exec
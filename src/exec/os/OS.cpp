@@ -1,6 +1,11 @@
 #include "exec/os/OS.h"
+#include "exec/os/clock.h"
+#include "exec/trace/trace.h"
+
+#include <time/mono.h>
 
 #include <algorithm>
+#include <cstdint>
 
 namespace exec {
 
@@ -9,8 +14,33 @@ OS::OS() {
 }
 
 void OS::tick() {
-    services_.iterate([](Service& s) { s.tick(); });
+    services_.iterate([](Service& s) {
+        trace::record(trace::Event::TickBegin, &s);
+
+#if EXEC_PROFILE
+        const auto now = ttime::mono::now();
+        const auto wake_at = s.wakeAt();
+        if (now >= wake_at) {
+            const auto late_ms = static_cast<uint64_t>(now.millis() - wake_at.millis());
+            s.stats_.due(late_ms < UINT32_MAX / 1000 ? late_ms * 1000 : UINT32_MAX);
+        }
+
+        const uint32_t start = nowMicros();
+        s.tick();
+        s.stats_.ticked(nowMicros() - start);
+#else
+        s.tick();
+#endif
+
+        trace::record(trace::Event::TickEnd, &s);
+    });
+}
+
+#if EXEC_PROFILE
+void OS::resetStats() {
+    services_.iterate([](Service& s) { s.stats_ = ServiceStats{}; });
 }
+#endif
 
 void OS::addService(Service* s) {
     services_.pushBack(s);
@@ -2,6 +2,10 @@
 
 #include "exec/os/Service.h"
 
+#if EXEC_PROFILE
+#include <cstdio>
+#endif
+
 namespace exec {
 
 class OS : public Service {
@@ -19,6 +23,29 @@ class OS : public Service {
         }
     }
 
+#if EXEC_PROFILE
+    // Calls f(const Service&) for every registered service in the tick order
+    template <typename F>
+    void forEachService(F&& f) const {
+        services_.iterate([&f](const Service& s) { f(s); });
+    }
+
+    void resetStats();
+
+    // Calls print(const char* line) with the stats of every service, e.g. Serial.println
+    template <typename F>
+    void printStats(F&& print) const {
+        char line[128];
+        unsigned index = 0;
+
+        services_.iterate([&](const Service& s) {
+            int n = std::snprintf(line, sizeof(line), "service #%u: ", index++);
+            s.stats().format(line + n, sizeof(line) - n);
+            print(static_cast<const char*>(line));
+        });
+    }
+#endif
+
  private:
     supp::IntrusiveForwardList<Service> services_;
 };
@@ -1,5 +1,11 @@
 #pragma once
 
+#include "exec/config.h"
+
+#if EXEC_PROFILE
+#include "exec/os/ServiceStats.h"
+#endif
+
 #include <supp/IntrusiveForwardList.h>
 #include <time/time.h>
 
@@ -10,6 +16,15 @@ class Service : public supp::IntrusiveForwardListNode<> {
     virtual ~Service() = default;
     virtual void tick() = 0;
     virtual ttime::Time wakeAt() const;  // ttime::Time::max() by default
+
+#if EXEC_PROFILE
+    const ServiceStats& stats() const { return stats_; }
+
+ private:
+    ServiceStats stats_;  // updated by OS
+
+    friend class OS;
+#endif
 };
 
 namespace detail {
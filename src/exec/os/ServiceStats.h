@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cinttypes>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+namespace exec {
+
+// Tick measurements of a single service, collected by OS with EXEC_PROFILE enabled.
+// Durations are in microseconds.
+struct ServiceStats {
+    uint32_t ticks = 0;
+    uint64_t totalUs = 0;
+    uint32_t maxUs = 0;
+    uint32_t lastUs = 0;
+
+    // Ticks made when the service was due, i.e. its wakeAt() had come,
+    // and how long after wakeAt() they happened
+    uint32_t dueTicks = 0;
+    uint32_t maxLateUs = 0;
+    uint32_t lastLateUs = 0;
+
+    void ticked(uint32_t us) {
+        ++ticks;
+        totalUs += us;
+        lastUs = us;
+        maxUs = us > maxUs ? us : maxUs;
+    }
+
+    void due(uint32_t lateUs) {
+        ++dueTicks;
+        lastLateUs = lateUs;
+        maxLateUs = lateUs > maxLateUs ? lateUs : maxLateUs;
+    }
+
+    uint32_t avgUs() const { return ticks == 0 ? 0 : static_cast<uint32_t>(totalUs / ticks); }
+
+    // Formats a single line into buf, returns the snprintf() result
+    int format(char* buf, size_t size) const {
+        return std::snprintf(buf, size,
+            "ticks=%" PRIu32 " total=%" PRIu32 "ms avg=%" PRIu32 "us max=%" PRIu32
+            "us last=%" PRIu32 "us due=%" PRIu32 " late max=%" PRIu32 "us last=%" PRIu32 "us",
+            ticks, static_cast<uint32_t>(totalUs / 1000), avgUs(), maxUs, lastUs, dueTicks,
+            maxLateUs, lastLateUs);
+    }
+};
+
+}  // namespace exec
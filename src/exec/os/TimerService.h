@@ -2,6 +2,7 @@
 
 #include "exec/Runnable.h"
 #include "exec/os/ServiceBase.h"
+#include "exec/trace/trace.h"
 
 #include <supp/RandomAccessPriorityQueue.h>
 
@@ -27,16 +28,26 @@ class HeapTimerService : public TimerService,
  public:
     bool add(TimerEntry* t) override {
         DASSERT(!t->connected());
+        trace::record(trace::Event::TimerAdd, t);
         return heap_.push(t);
     }
 
-    bool remove(TimerEntry* t) override { return heap_.erase(t); }
+    bool remove(TimerEntry* t) override {
+        if (!heap_.erase(t)) {
+            return false;
+        }
+
+        trace::record(trace::Event::TimerCancel, t);
+        return true;
+    }
 
     void tick() override {
         auto now = ttime::mono::now();
 
         while (!heap_.empty() && now >= heap_.front()->at) {
-            heap_.pop()->run();
+            auto* t = heap_.pop();
+            trace::record(trace::Event::TimerFire, t);
+            t->run();
         }
     }
 
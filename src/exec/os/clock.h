@@ -0,0 +1,28 @@
+#pragma once
+
+#include <time/config.h>
+#include <time/mono.h>
+
+#include <cstdint>
+
+#if !TIME_MANUAL && !defined(ARDUINO)
+#include <chrono>
+#endif
+
+namespace exec {
+
+// Microseconds for measurements, wraps around.
+// Manual time only has millisecond resolution.
+inline uint32_t nowMicros() {
+#if TIME_MANUAL
+    return static_cast<uint32_t>(ttime::mono::now().millis() * 1000);
+#elif defined(ARDUINO)
+    return micros();
+#else
+    using namespace std::chrono;
+    return static_cast<uint32_t>(
+        duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+}  // namespace exec
@@ -6,42 +6,157 @@
 #include <supp/verify.h>
 
 #include <concepts>
+#include <cstdint>
+#include <cstring>
 #include <new>  // IWYU pragma: keep
+#include <type_traits>
 #include <utility>
 
 namespace exec {
 
+// Result<T> keeps the error code inside of T's bytes when ResultNiche<T> is enabled,
+// saving the code byte and the padding after it.
+//
+// Specializations provide:
+//   static ErrCode code(const uint8_t* bytes): ErrCode::Success if the bytes hold a value
+//   static void setError(uint8_t* bytes, ErrCode code): bytes hold no value
 template <typename T>
-class Result {  // NOLINT
+struct ResultNiche {
+    static constexpr bool enabled = false;
+};
+
+// Niche of an integer representation Repr: values from First on encode error codes
+// and are never taken by valid values.
+template <typename Repr, Repr First>
+struct RangeNiche {
+    static constexpr bool enabled = true;
+    static constexpr auto Errors = static_cast<Repr>(ErrCode::Success);
+
+    static_assert(std::is_unsigned_v<Repr>);
+    static_assert(Repr(First + Errors) > First, "not enough room for error codes");
+
+    static ErrCode code(const uint8_t* bytes) {
+        Repr v;
+        std::memcpy(&v, bytes, sizeof(v));
+        return Repr(v - First) < Errors ? static_cast<ErrCode>(v - First) : ErrCode::Success;
+    }
+
+    static void setError(uint8_t* bytes, ErrCode code) {
+        const Repr v = First + static_cast<Repr>(code);
+        std::memcpy(bytes, &v, sizeof(v));
+    }
+};
+
+// Objects never live at the lowest addresses, nullptr stays a valid value
+template <typename T>
+struct ResultNiche<T*> : RangeNiche<uintptr_t, 1> {};
+
+template <>
+struct ResultNiche<bool> : RangeNiche<uint8_t, 2> {
+    static_assert(sizeof(bool) == 1);
+};
+
+// Enums opt in by naming their first unused underlying value:
+//   template <> struct ResultNiche<Color> : EnumNiche<Color, 3> {};
+template <typename E, std::underlying_type_t<E> First>
+requires std::is_enum_v<E>
+struct EnumNiche : RangeNiche<std::make_unsigned_t<std::underlying_type_t<E>>,
+                       static_cast<std::make_unsigned_t<std::underlying_type_t<E>>>(First)> {};
+
+namespace detail {
+
+template <typename T, bool Niche = ResultNiche<T>::enabled>
+class ResultStorage {
+ protected:
+    ErrCode code() const { return code_; }
+
+    // Only when no value is stored
+    void setCode(ErrCode code) { code_ = code; }
+
+    // A value has been placed into ptr()
+    void constructed() { code_ = ErrCode::Success; }
+
+    void release() {
+        ptr()->~T();
+        code_ = ErrCode::Unknown;
+    }
+
+    T* ptr() { return reinterpret_cast<T*>(data_); }
+    const T* ptr() const { return reinterpret_cast<const T*>(data_); }
+
+ private:
+    alignas(T) uint8_t data_[sizeof(T)] /* uninitialized */;
+    ErrCode code_ = ErrCode::Unknown;
+};
+
+template <typename T>
+class ResultStorage<T, true> {
+ protected:
+    static_assert(std::is_trivially_copyable_v<T>, "niche types are inspected bytewise");
+
+    ResultStorage() { setCode(ErrCode::Unknown); }
+
+    ErrCode code() const { return ResultNiche<T>::code(data_); }
+    void setCode(ErrCode code) { ResultNiche<T>::setError(data_, code); }
+
+    void constructed() const {
+        DASSERT(code() == ErrCode::Success, "value collides with the niche");
+    }
+
+    void release() { setCode(ErrCode::Unknown); }
+
+    T* ptr() { return reinterpret_cast<T*>(data_); }
+    const T* ptr() const { return reinterpret_cast<const T*>(data_); }
+
+ private:
+    alignas(T) uint8_t data_[sizeof(T)];
+};
+
+}  // namespace detail
+
+template <typename T>
+class Result : detail::ResultStorage<T> {  // NOLINT
+    using Storage = detail::ResultStorage<T>;
+    using Storage::constructed;
+    using Storage::ptr;
+    using Storage::release;
+    using Storage::setCode;
+
  public:
     using ValueType = T;
 
     Result() = default;
 
-    explicit Result(ErrCode code) : code_{code} {  // NOLINT
-        DASSERT(!hasValue(), "cannot construct Result<T> with Success code");
+    explicit Result(ErrCode code) {  // NOLINT
+        DASSERT(code != ErrCode::Success, "cannot construct Result<T> with Success code");
+        setCode(code);
     }
 
     template <typename U>
     requires(!std::same_as<std::remove_reference_t<U>, Result>)
-    Result(U&& val) : code_{ErrCode::Success} {  // NOLINT
+    Result(U&& val) {  // NOLINT
         new (ptr()) T(std::forward<U>(val));
+        constructed();
     }
 
-    Result(Result&& r) noexcept : code_{r.code_} {  // NOLINT
-        if (!hasValue()) {
+    Result(Result&& r) noexcept {  // NOLINT
+        if (!r.hasValue()) {
+            setCode(r.code());
             return;
         }
 
         new (ptr()) T(std::move(r).get());
+        constructed();
     }
 
-    Result(const Result& r) : code_{r.code_} {  // NOLINT
-        if (!hasValue()) {
+    Result(const Result& r) {  // NOLINT
+        if (!r.hasValue()) {
+            setCode(r.code());
             return;
         }
 
         new (ptr()) T(r.get());
+        constructed();
     }
 
     Result& operator=(const Result& r) {
@@ -53,13 +168,13 @@ class Result {  // NOLINT
             if (hasValue()) {
                 release();
             }
-            code_ = r.code_;
+            setCode(r.code());
         } else {  // r.hasValue()
             if (hasValue()) {
                 get() = r.get();
             } else {  // !hasValue()
-                code_ = ErrCode::Success;
                 new (ptr()) T(r.get());
+                constructed();
             }
         }
 
@@ -75,13 +190,14 @@ class Result {  // NOLINT
             if (hasValue()) {
                 release();
             }
-            code_ = std::exchange(r.code_, ErrCode::Unknown);
+            setCode(r.code());
+            r.setCode(ErrCode::Unknown);
         } else {  // r.hasValue()
             if (hasValue()) {
                 get() = std::move(r).get();
             } else {  // !hasValue()
-                code_ = ErrCode::Success;
                 new (ptr()) T(std::move(r).get());
+                constructed();
             }
         }
 
@@ -101,7 +217,7 @@ class Result {  // NOLINT
             release();
         }
 
-        code_ = code;
+        setCode(code);
     }
 
     template <typename U>
@@ -109,12 +225,12 @@ class Result {  // NOLINT
         if (hasValue()) {
             get() = std::forward<U>(val);
         } else {
-            code_ = ErrCode::Success;
             new (ptr()) T(std::forward<U>(val));
+            constructed();
         }
     }
 
-    bool hasValue() const { return code_ == ErrCode::Success; }
+    bool hasValue() const { return code() == ErrCode::Success; }
     explicit operator bool() const { return hasValue(); }
 
     T& operator*() { return get(); }
@@ -140,20 +256,7 @@ class Result {  // NOLINT
         return *ptr();
     }
 
-    ErrCode code() const { return code_; }
-
- private:
-    void release() {
-        DASSERT(hasValue());
-        ptr()->~T();
-        code_ = ErrCode::Unknown;
-    }
-
-    T* ptr() { return reinterpret_cast<T*>(data_); }
-    const T* ptr() const { return reinterpret_cast<const T*>(data_); }
-
-    alignas(T) uint8_t data_[sizeof(T)] /* uninitialized */;
-    ErrCode code_ = ErrCode::Unknown;
+    ErrCode code() const { return Storage::code(); }
 };
 
 template <>
@@ -218,34 +321,29 @@ class Result<Unit> {  // NOLINT
     ErrCode code_ = ErrCode::Unknown;
 };
 
+// A reference is never null, its pointer carries the error code
 template <typename T>
 class Result<T&> {  // NOLINT
+    using Niche = RangeNiche<uintptr_t, 0>;
+
  public:
     using ValueType = T&;
 
     Result() = default;
 
-    explicit Result(ErrCode code) : code_{code} {
-        DASSERT(!hasValue(), "cannot construct Result<T&> with Success code");
+    explicit Result(ErrCode code) {
+        DASSERT(code != ErrCode::Success, "cannot construct Result<T&> with Success code");
+        setCode(code);
     }
 
     template <typename U>
     requires(!std::same_as<std::remove_reference_t<U>, Result>)
-    Result(U& val) : ptr_{&val}
-                   , code_{ErrCode::Success} {}
+    Result(U& val) : ptr_{&val} {}
 
-    Result(Result&& r) noexcept
-        : ptr_{std::exchange(r.ptr_, nullptr)}
-        , code_{std::exchange(r.code_, ErrCode::Unknown)} {}
-
-    Result(const Result& r) : ptr_{r.ptr_}, code_{r.code_} {}
+    Result(Result&& r) noexcept : ptr_{std::exchange(r.ptr_, nullptr)} {}
+    Result(const Result& r) : ptr_{r.ptr_} {}
 
     Result& operator=(const Result& r) {
-        if (this == &r) {
-            return *this;
-        }
-
-        code_ = r.code_;
         ptr_ = r.ptr_;
         return *this;
     }
@@ -255,24 +353,21 @@ class Result<T&> {  // NOLINT
             return *this;
         }
 
-        code_ = std::exchange(r.code_, ErrCode::Unknown);
         ptr_ = std::exchange(r.ptr_, nullptr);
         return *this;
     }
 
     void setError(ErrCode code) {
         DASSERT(code != ErrCode::Success, "cannot setError with Success code");
-        ptr_ = nullptr;
-        code_ = code;
+        setCode(code);
     }
 
     template <typename U>
     void emplace(U& val) {
         ptr_ = &val;
-        code_ = ErrCode::Success;
     }
 
-    bool hasValue() const { return code_ == ErrCode::Success; }
+    bool hasValue() const { return code() == ErrCode::Success; }
     explicit operator bool() const { return hasValue(); }
 
     T& operator*() { return get(); }
@@ -283,9 +378,7 @@ class Result<T&> {  // NOLINT
 
     T& get() && {
         DASSERT(hasValue());
-        auto ptr = ptr_;
-        *this = Result<T&>();
-        return *ptr;
+        return *std::exchange(ptr_, nullptr);
     }
 
     T& get() & {
@@ -298,11 +391,12 @@ class Result<T&> {  // NOLINT
         return *ptr_;
     }
 
-    ErrCode code() const { return code_; }
+    ErrCode code() const { return Niche::code(reinterpret_cast<const uint8_t*>(&ptr_)); }
 
  private:
-    T* ptr_ = nullptr;
-    ErrCode code_ = ErrCode::Unknown;
+    void setCode(ErrCode code) { Niche::setError(reinterpret_cast<uint8_t*>(&ptr_), code); }
+
+    T* ptr_ = nullptr;  // nullptr is ErrCode::Unknown
 };
 
 using Status = Result<Unit>;
@@ -4,67 +4,238 @@
 
 #include <supp/NonCopyable.h>
 
+#include <cstddef>
+#include <tuple>
 #include <type_traits>
 #include <utility>
 
 namespace exec {
 
+template <typename T>
+class Async;
+
 namespace pipe {
 
+// A stage hands its value or error over to the next one instead of returning a Result<T>,
+// so stages fused into a Pipeline keep intermediate values in place:
+//
+//   template <typename T> using Out = value type after the stage
+//   Ret onValue(T&& value, Next next): ends with next.value(U&&) or next.error(ErrCode)
+//   Ret onError(ErrCode code, Next next)
+template <typename... Stages>
+struct Pipeline;
+
+namespace detail {
+
+template <typename T, typename... Stages>
+struct PipeOut {
+    using type = T;
+};
+
+template <typename T, typename S, typename... Rest>
+struct PipeOut<T, S, Rest...> : PipeOut<typename S::template Out<T>, Rest...> {};
+
+// Value type after all the stages
+template <typename T, typename... Stages>
+using PipeOutT = typename PipeOut<T, Stages...>::type;
+
+template <typename Final, typename... Stages>
+class Fused {
+ public:
+    explicit Fused(Stages&... stages) : stages_{stages...} {}
+
+    template <typename T>
+    Result<Final> run(Result<T>&& r) {
+        if (r.hasValue()) {
+            return Next<0>{this}.value(static_cast<T&&>(*r));
+        }
+
+        return Next<0>{this}.error(r.code());
+    }
+
+ private:
+    template <size_t I>
+    struct Next {
+        template <typename V>
+        Result<Final> value(V&& v) const {
+            if constexpr (I == sizeof...(Stages)) {
+                return Result<Final>(std::forward<V>(v));
+            } else {
+                return std::get<I>(self->stages_).onValue(std::forward<V>(v), Next<I + 1>{self});
+            }
+        }
+
+        Result<Final> error(ErrCode code) const {
+            if constexpr (I == sizeof...(Stages)) {
+                return err<Final>(code);
+            } else {
+                return std::get<I>(self->stages_).onError(code, Next<I + 1>{self});
+            }
+        }
+
+        Fused* self;
+    };
+
+    std::tuple<Stages&...> stages_;
+};
+
+template <typename T, typename... Stages>
+Result<PipeOutT<T, Stages...>> runFused(Result<T>&& r, Stages&... stages) {
+    return Fused<PipeOutT<T, Stages...>, Stages...>{stages...}.run(std::move(r));
+}
+
+// Pipelines with asynchronous stages run in a single Async, see exec/coro/pipe.h
+template <typename T, typename... Stages>
+Async<PipeOutT<T, Stages...>> runAsync(Result<T> input, std::tuple<Stages...> stages);
+
+template <typename Self>
+struct Stage : supp::NonCopyable {
+    static constexpr bool IsAsync = false;
+
+    template <typename T>
+    auto pipe(Result<T>&& r) {
+        auto& self = static_cast<Self&>(*this);
+
+        if constexpr (Self::IsAsync) {
+            return runAsync(std::move(r), std::tuple<Self>(std::move(self)));
+        } else {
+            return runFused(std::move(r), self);
+        }
+    }
+
+    template <typename T>
+    auto pipe(const Result<T>& r) {
+        return pipe(Result<T>(r));
+    }
+};
+
+template <typename T>
+struct IsPipeline : std::false_type {};
+
+template <typename... Stages>
+struct IsPipeline<Pipeline<Stages...>> : std::true_type {};
+
+template <typename S>
+concept IsStage = std::is_base_of_v<Stage<S>, S>;
+
+template <typename S>
+concept Composable = IsStage<S> || IsPipeline<S>::value;
+
+template <IsStage S>
+std::tuple<S> stagesOf(S&& s) {
+    return std::tuple<S>(std::move(s));
+}
+
+template <typename... Stages>
+std::tuple<Stages...> stagesOf(Pipeline<Stages...>&& p) {
+    return std::move(p.stages);
+}
+
+}  // namespace detail
+
 template <typename F>
-struct [[nodiscard]] AndThen : supp::NonCopyable {
+struct [[nodiscard]] AndThen : detail::Stage<AndThen<F>> {
     F user;
 
     explicit AndThen(F u) : user(std::move(u)) {}
 
     template <typename T>
-    using U = traits::ValueOf<std::invoke_result_t<F, T>>;
+    using Out = traits::ValueOf<std::invoke_result_t<F&, T&&>>;
 
-    template <typename T>
-    Result<U<T>> pipe(Result<T> r) {
-        if (r.hasValue()) {
-            return user(std::move(r).get());
+    template <typename T, typename Next>
+    auto onValue(T&& value, Next next) {
+        auto r = user(std::forward<T>(value));
+        if (!r.hasValue()) {
+            return next.error(r.code());
         }
 
-        return err<U<T>>(r.code());
+        // the value stays in r until the rest of the pipeline has consumed it
+        return next.value(static_cast<traits::ValueOf<decltype(r)>&&>(*r));
+    }
+
+    template <typename Next>
+    auto onError(ErrCode code, Next next) {
+        return next.error(code);
     }
 };
 
 template <typename F>
-struct [[nodiscard]] OrElse : supp::NonCopyable {
+struct [[nodiscard]] OrElse : detail::Stage<OrElse<F>> {
     F user;
 
     explicit OrElse(F u) : user(std::move(u)) {}
 
     template <typename T>
-    Result<T> pipe(Result<T> r) {
-        if (r.hasValue()) {
-            return r;
+    using Out = T;
+
+    template <typename T, typename Next>
+    auto onValue(T&& value, Next next) {
+        return next.value(std::forward<T>(value));
+    }
+
+    template <typename Next>
+    auto onError(ErrCode code, Next next) {
+        auto r = user(code);
+        if (!r.hasValue()) {
+            return next.error(r.code());
         }
 
-        return user(r.code());
+        return next.value(static_cast<traits::ValueOf<decltype(r)>&&>(*r));
     }
 };
 
 template <typename F>
-struct [[nodiscard]] Map : supp::NonCopyable {
+struct [[nodiscard]] Map : detail::Stage<Map<F>> {
     F user;
 
     explicit Map(F u) : user(std::move(u)) {}
 
     template <typename T>
-    using U = std::invoke_result_t<F, T>;
+    using Out = std::invoke_result_t<F&, T&&>;
+
+    template <typename T, typename Next>
+    auto onValue(T&& value, Next next) {
+        return next.value(user(std::forward<T>(value)));
+    }
+
+    template <typename Next>
+    auto onError(ErrCode code, Next next) {
+        return next.error(code);
+    }
+};
 
+// Stages fused into a single callable: r | (a | b | c) passes values from stage to stage
+// without wrapping them into a Result<T> in between.
+template <typename... Stages>
+struct [[nodiscard]] Pipeline : supp::NonCopyable {
+    static constexpr bool IsAsync = (... || Stages::IsAsync);
+
+    explicit Pipeline(std::tuple<Stages...>&& s) : stages(std::move(s)) {}
+
+    // Asynchronous pipelines move the stages into the returned Async
     template <typename T>
-    Result<U<T>> pipe(Result<T> r) {
-        if (r.hasValue()) {
-            return ok<U<T>>(user(std::move(r).get()));
+    auto pipe(Result<T>&& r) {
+        if constexpr (IsAsync) {
+            return detail::runAsync(std::move(r), std::move(stages));
+        } else {
+            return std::apply(
+                [&r](Stages&... s) { return detail::runFused(std::move(r), s...); }, stages);
         }
+    }
 
-        return err<U<T>>(r.code());
+    template <typename T>
+    auto pipe(const Result<T>& r) {
+        return pipe(Result<T>(r));
     }
+
+    std::tuple<Stages...> stages;
 };
 
+template <detail::Composable A, detail::Composable B>
+auto operator|(A&& a, B&& b) {
+    return Pipeline{std::tuple_cat(detail::stagesOf(std::move(a)), detail::stagesOf(std::move(b)))};
+}
+
 }  // namespace pipe
 
 /*
@@ -5,6 +5,11 @@
 #include <utility>
 
 template <typename T, typename C>
-auto operator|(exec::Result<T> r, C c) {
+auto operator|(exec::Result<T>&& r, C&& c) {
     return c.pipe(std::move(r));
 }
+
+template <typename T, typename C>
+auto operator|(const exec::Result<T>& r, C&& c) {
+    return c.pipe(r);
+}
@@ -0,0 +1,139 @@
+#pragma once
+
+#include "exec/trace/trace.h"
+
+#include <cstddef>
+#include <cstdint>
+
+#if !defined(ARDUINO)
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <vector>
+#endif
+
+namespace exec::trace {
+
+inline const char* name(Event event) {
+    switch (event) {
+        case Event::FrameCreate:
+            return "create";
+        case Event::FrameResume:
+            return "resume";
+        case Event::FrameSuspend:
+            return "suspend";
+        case Event::FrameDestroy:
+            return "destroy";
+        case Event::Post:
+            return "post";
+        case Event::Run:
+            return "run";
+        case Event::TimerAdd:
+            return "timer add";
+        case Event::TimerFire:
+            return "timer fire";
+        case Event::TimerCancel:
+            return "timer cancel";
+        case Event::TickBegin:
+        case Event::TickEnd:
+            return "tick";
+    }
+
+    return "?";
+}
+
+// Writes the kept records to anything with write(const uint8_t*, size_t), e.g. Serial.
+//
+// Layout, native byte order:
+//   header: 'E' 'T' version(1) sizeof(void*) count(uint32) dropped(uint32)
+//   record: ts(uint32) object(sizeof(void*)) event(uint8)
+template <typename Out>
+void dumpBinary(Out& out) {
+    auto put = [&out](const void* data, size_t len) {
+        out.write(static_cast<const uint8_t*>(data), len);
+    };
+
+    const uint8_t header[] = {'E', 'T', 1, sizeof(void*)};
+    const uint32_t count = size();
+    const uint32_t lost = dropped();
+    put(header, sizeof(header));
+    put(&count, sizeof(count));
+    put(&lost, sizeof(lost));
+
+    forEach([&put](const Record& r) {
+        put(&r.ts, sizeof(r.ts));
+        put(&r.object, sizeof(r.object));
+        put(&r.event, sizeof(r.event));
+    });
+}
+
+#if !defined(ARDUINO)
+
+// Writes the kept records as Chrome trace JSON (chrome://tracing, ui.perfetto.dev).
+// Every frame gets its own track showing when it runs, service ticks are shown on track 0
+// with executor and timer events as instants inside of them.
+inline void writeChromeTrace(std::FILE* out) {
+    std::vector<const void*> running;
+
+    auto isRunning = [&running](const void* frame) {
+        return std::find(running.begin(), running.end(), frame) != running.end();
+    };
+
+    const char* sep = "";
+    auto emit = [&](const Record& r, const char* ph, uintptr_t tid, const char* label = nullptr) {
+        std::fprintf(out,
+            "%s\n{\"name\":\"%s\",\"ph\":\"%s\",\"ts\":%" PRIu32 ",\"pid\":0,\"tid\":%" PRIuPTR
+            ",\"args\":{\"object\":\"%p\"}%s}",
+            sep, label ? label : name(r.event), ph, r.ts, tid, r.object, ph[0] == 'i' ? ",\"s\":\"t\"" : "");
+        sep = ",";
+    };
+
+    std::fprintf(out, "{\"traceEvents\":[");
+
+    forEach([&](const Record& r) {
+        const auto frame = reinterpret_cast<uintptr_t>(r.object);
+
+        switch (r.event) {
+            case Event::FrameCreate:
+                emit(r, "i", frame);
+                break;
+
+            case Event::FrameResume:
+                // records of the enclosing suspension may have been overwritten
+                if (!isRunning(r.object)) {
+                    running.push_back(r.object);
+                    emit(r, "B", frame, "running");
+                }
+                break;
+
+            case Event::FrameSuspend:
+            case Event::FrameDestroy:
+                if (isRunning(r.object)) {
+                    std::erase(running, r.object);
+                    emit(r, "E", frame, "running");
+                }
+                if (r.event == Event::FrameDestroy) {
+                    emit(r, "i", frame);
+                }
+                break;
+
+            case Event::TickBegin:
+                emit(r, "B", 0);
+                break;
+
+            case Event::TickEnd:
+                emit(r, "E", 0);
+                break;
+
+            default:
+                emit(r, "i", 0);
+                break;
+        }
+    });
+
+    std::fprintf(out, "\n],\"displayTimeUnit\":\"ms\"}\n");
+}
+
+#endif
+
+}  // namespace exec::trace
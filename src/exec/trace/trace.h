@@ -0,0 +1,96 @@
+#pragma once
+
+#include "exec/config.h"
+#include "exec/os/clock.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace exec::trace {
+
+enum class Event : uint8_t {
+    FrameCreate,   // Async, spawned or scope task frame allocated
+    FrameResume,   // the frame starts running
+    FrameSuspend,  // the frame has parked on an awaitable
+    FrameDestroy,  // the frame is freed
+    Post,          // runnable posted to the executor
+    Run,           // runnable run by the executor
+    TimerAdd,
+    TimerFire,
+    TimerCancel,
+    TickBegin,  // OS ticks a service
+    TickEnd,
+};
+
+struct Record {
+    uint32_t ts;  // microseconds
+    const void* object;
+    Event event;
+};
+
+#if EXEC_TRACE
+
+namespace detail {
+
+struct Buffer {
+    Record records[EXEC_TRACE_CAPACITY] /* uninitialized */;
+    uint32_t written = 0;  // total number of records, the last EXEC_TRACE_CAPACITY are kept
+};
+
+inline Buffer buffer_;
+
+}  // namespace detail
+
+#endif
+
+// Compiles away unless EXEC_TRACE is enabled.
+// Not interrupt safe: ISRs must not record.
+inline void record(Event event, const void* object) {
+#if EXEC_TRACE
+    auto& b = detail::buffer_;
+    b.records[b.written++ % EXEC_TRACE_CAPACITY] = Record{nowMicros(), object, event};
+#else
+    (void)event;
+    (void)object;
+#endif
+}
+
+// Number of records kept
+inline size_t size() {
+#if EXEC_TRACE
+    auto written = detail::buffer_.written;
+    return written < EXEC_TRACE_CAPACITY ? written : EXEC_TRACE_CAPACITY;
+#else
+    return 0;
+#endif
+}
+
+// Number of records overwritten since the last clear()
+inline uint32_t dropped() {
+#if EXEC_TRACE
+    return detail::buffer_.written - size();
+#else
+    return 0;
+#endif
+}
+
+inline void clear() {
+#if EXEC_TRACE
+    detail::buffer_.written = 0;
+#endif
+}
+
+// Visits the kept records from the oldest to the newest: f(const Record&)
+template <typename F>
+void forEach(F&& f) {
+#if EXEC_TRACE
+    const auto& b = detail::buffer_;
+    for (uint32_t i = b.written - size(); i != b.written; ++i) {
+        f(b.records[i % EXEC_TRACE_CAPACITY]);
+    }
+#else
+    (void)f;
+#endif
+}
+
+}  // namespace exec::trace
@@ -10,6 +10,22 @@ class Executor : public exec::Executor {
         queued.pushBack(r);
     }
 
+    bool remove(exec::Runnable* r) override {
+        auto q = std::move(queued);
+        bool removed = false;
+
+        while (!q.empty()) {
+            auto* p = q.popFront();
+            if (p == r) {
+                removed = true;
+            } else {
+                queued.pushBack(p);
+            }
+        }
+
+        return removed;
+    }
+
     supp::IntrusiveForwardList<exec::Runnable> queued;
 };
 
@@ -0,0 +1,203 @@
+#include "coro/test.h"
+
+#include <exec/coro/Async.h>
+#include <exec/coro/ManualTask.h>
+#include <exec/coro/alloc.h>
+#include <exec/coro/par/select.h>
+#include <exec/coro/sync/Event.h>
+#include <exec/coro/sync/MPMCChannel.h>
+#include <exec/coro/sync/Mutex.h>
+#include <exec/coro/wait.h>
+
+#include <utest/utest.h>
+
+void setUp() {
+    static_assert(TIME_MANUAL, "manual time is expected for tests");
+    ttime::mono::set(ttime::Time());
+}
+
+namespace exec {
+
+struct t_select : t_coro {
+    MPMCChannel<int, 2> a;
+    MPMCChannel<int, 2> b;
+    Event e;
+};
+
+TEST_F(t_select, first_ready_wins) {
+    int v1 = 1;
+    int v2 = 2;
+
+    auto coro = makeManualTask([](auto& a, auto& b, int& v1, int& v2) -> Async<> {
+        TEST_ASSERT_TRUE(co_await a.send(v1));
+        TEST_ASSERT_TRUE(co_await b.send(v2));
+
+        auto res = co_await select(b.receive(), a.receive());
+        TEST_ASSERT_TRUE(res);
+        TEST_ASSERT_EQUAL(0, res->index());
+        TEST_ASSERT_EQUAL(2, *std::get<0>(*res));
+
+        // a has not been touched
+        TEST_ASSERT_EQUAL(1, *co_await a.receive());
+    }(a, b, v1, v2));
+
+    coro.start();
+    TEST_ASSERT_TRUE(coro.done());
+}
+
+TEST_F(t_select, exactly_one_branch_takes_value) {
+    auto coro = makeManualTask([](auto& a, auto& b, auto& e) -> Async<> {
+        auto res = co_await select(a.receive(), b.receive(), e.wait());
+        TEST_ASSERT_TRUE(res);
+        TEST_ASSERT_EQUAL(1, res->index());
+        TEST_ASSERT_EQUAL(20, *std::get<1>(*res));
+    }(a, b, e));
+
+    const size_t allocated = alloc::allocatedCount();
+    coro.start();
+    TEST_ASSERT_FALSE(coro.done());
+    TEST_ASSERT_EQUAL(allocated, alloc::allocatedCount());  // no frames for branches
+
+    int v = 20;
+    auto sender = makeManualTask([](auto& b, int& v) -> Async<> {
+        TEST_ASSERT_TRUE(co_await b.send(v));
+    }(b, v));
+
+    sender.start();
+    TEST_ASSERT_TRUE(coro.done());
+
+    // losers are not parked anymore, values stay in the channel
+    int w = 10;
+    auto sender2 = makeManualTask([](auto& a, int& w) -> Async<> {
+        TEST_ASSERT_TRUE(co_await a.send(w));
+    }(a, w));
+
+    sender2.start();
+    TEST_ASSERT_TRUE(sender2.done());
+
+    auto receiver = makeManualTask([](auto& a) -> Async<> {
+        TEST_ASSERT_EQUAL(10, *co_await a.receive());
+    }(a));
+
+    receiver.start();
+    TEST_ASSERT_TRUE(receiver.done());
+}
+
+TEST_F(t_select, timeout) {
+    HeapTimerService<1> timers;
+
+    auto coro = makeManualTask([](auto& a) -> Async<> {
+        auto res = co_await select(a.receive(), wait(ttime::Duration(10)));
+        TEST_ASSERT_TRUE(res);
+        TEST_ASSERT_EQUAL(1, res->index());
+        TEST_ASSERT_EQUAL(ErrCode::Success, std::get<1>(*res));
+    }(a));
+
+    coro.start();
+    TEST_ASSERT_FALSE(coro.done());
+
+    ttime::mono::advance(ttime::Duration(10));
+    timers.tick();
+    TEST_ASSERT_TRUE(coro.done());
+}
+
+TEST_F(t_select, winner_cancels_timer) {
+    HeapTimerService<1> timers;
+
+    auto coro = makeManualTask([](auto& e) -> Async<> {
+        auto res = co_await select(wait(ttime::Duration(10)), e.wait());
+        TEST_ASSERT_TRUE(res);
+        TEST_ASSERT_EQUAL(1, res->index());
+    }(e));
+
+    coro.start();
+    TEST_ASSERT_EQUAL(1, timers.size());
+
+    e.set();
+    TEST_ASSERT_TRUE(coro.done());
+    TEST_ASSERT_EQUAL(0, timers.size());
+}
+
+TEST_F(t_select, cancel) {
+    CancellationSignal sig;
+
+    auto coro = makeManualTask([](auto& a, auto& e, auto slot) -> Async<> {
+        auto res = co_await select(a.receive(), e.wait()).setCancellationSlot(slot);
+        TEST_ASSERT_EQUAL(ErrCode::Cancelled, res.code());
+    }(a, e, sig.slot()));
+
+    coro.start();
+    TEST_ASSERT_TRUE(sig.hasHandler());
+
+    sig.emitSync();
+    TEST_ASSERT_TRUE(coro.done());
+
+    // nobody is parked on the event anymore
+    e.fireOnce();
+}
+
+Async<> waitEvent(Event& e) {
+    (void)co_await e.wait();
+}
+
+static_assert(Selectable<decltype(std::declval<MPMCChannel<int, 2>&>().receive())>);
+static_assert(Selectable<Async<>>);
+static_assert(Selectable<decltype(std::declval<Async<>>().eager())>);
+static_assert(Selectable<decltype(std::declval<Mutex&>().lock())>);
+
+// could take a value while another branch wins
+static_assert(!Selectable<Async<int>>);
+static_assert(!Selectable<decltype(std::declval<MPMCChannel<int, 2>&>().receiveMany(
+        std::declval<std::span<int>>(), 1, 2))>);
+
+TEST_F(t_select, cancel_async_branches) {
+    CancellationSignal sig;
+    Event e2;
+
+    auto coro = makeManualTask([](auto& e, auto& e2, auto slot) -> Async<> {
+        auto res = co_await select(waitEvent(e), waitEvent(e2)).setCancellationSlot(slot);
+        TEST_ASSERT_EQUAL(ErrCode::Cancelled, res.code());
+    }(e, e2, sig.slot()));
+
+    coro.start();
+    TEST_ASSERT_FALSE(coro.done());
+
+    // cancelled Async branches arrive through their own frames, not through the resumers
+    sig.emitSync();
+    TEST_ASSERT_TRUE(coro.done());
+}
+
+TEST_F(t_select, eager_branch_loses) {
+    Event e2;
+    e2.set();
+
+    auto coro = makeManualTask([](auto& e, auto& e2) -> Async<> {
+        auto res = co_await select(waitEvent(e).eager(), e2.wait());
+        TEST_ASSERT_TRUE(res);
+        TEST_ASSERT_EQUAL(1, res->index());
+    }(e, e2));
+
+    coro.start();
+    TEST_ASSERT_TRUE(coro.done());
+
+    // nobody is parked on the event anymore
+    e.fireOnce();
+}
+
+TEST_F(t_select, eager_branch_completes_inline) {
+    Event e2;
+    e.set();
+
+    auto coro = makeManualTask([](auto& e, auto& e2) -> Async<> {
+        auto res = co_await select(waitEvent(e).eager(), e2.wait());
+        TEST_ASSERT_TRUE(res);
+        TEST_ASSERT_EQUAL(0, res->index());
+    }(e, e2));
+
+    coro.start();
+    TEST_ASSERT_TRUE(coro.done());
+}
+
+}  // namespace exec
+
+TESTS_MAIN
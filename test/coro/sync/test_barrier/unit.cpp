@@ -0,0 +1,93 @@
+#include "coro/test.h"
+
+#include <exec/coro/Async.h>
+#include <exec/coro/ManualTask.h>
+#include <exec/coro/sync/Barrier.h>
+#include <exec/coro/sync/Event.h>
+
+#include <utest/utest.h>
+
+namespace exec {
+
+struct t_barrier : t_coro {
+    Barrier b{3};
+};
+
+namespace {
+
+// Arrives at the barrier in every phase, work of the phase ends with the event
+Async<> participant(Barrier& b, Event& step, int phases, int& completed) {
+    for (int i = 0; i < phases; ++i) {
+        (void)co_await step.wait();
+        TEST_ASSERT_EQUAL(ErrCode::Success, co_await b.arriveAndWait());
+        ++completed;
+    }
+}
+
+}  // namespace
+
+TEST_F(t_barrier, releases_all_participants) {
+    Event s1, s2, s3;
+    int completed = 0;
+
+    auto p1 = makeManualTask(participant(b, s1, 2, completed));
+    auto p2 = makeManualTask(participant(b, s2, 2, completed));
+    auto p3 = makeManualTask(participant(b, s3, 2, completed));
+
+    p1.start();
+    p2.start();
+    p3.start();
+
+    s1.fireOnce();
+    s2.fireOnce();
+    TEST_ASSERT_EQUAL(0, completed);
+    TEST_ASSERT_EQUAL(0, b.phase());
+
+    s3.fireOnce();  // the last one arrives
+    TEST_ASSERT_EQUAL(3, completed);
+    TEST_ASSERT_EQUAL(1, b.phase());
+
+    // next phase
+    s3.fireOnce();
+    s1.fireOnce();
+    TEST_ASSERT_EQUAL(3, completed);
+
+    s2.fireOnce();
+    TEST_ASSERT_EQUAL(6, completed);
+    TEST_ASSERT_EQUAL(2, b.phase());
+    TEST_ASSERT_TRUE(p1.done());
+    TEST_ASSERT_TRUE(p2.done());
+    TEST_ASSERT_TRUE(p3.done());
+}
+
+TEST_F(t_barrier, cancelled_participant_does_not_count) {
+    CancellationSignal sig;
+    Event s1, s2;
+    int completed = 0;
+
+    auto cancelled = makeManualTask([](Barrier& b, CancellationSlot slot) -> Async<> {
+        TEST_ASSERT_EQUAL(ErrCode::Cancelled, co_await b.arriveAndWait().setCancellationSlot(slot));
+    }(b, sig.slot()));
+
+    auto p1 = makeManualTask(participant(b, s1, 1, completed));
+    auto p2 = makeManualTask(participant(b, s2, 1, completed));
+    auto p3 = makeManualTask(participant(b, s2, 1, completed));
+
+    cancelled.start();
+    p1.start();
+    p2.start();
+    p3.start();
+
+    sig.emitSync();
+    TEST_ASSERT_TRUE(cancelled.done());
+
+    s1.fireOnce();
+    TEST_ASSERT_EQUAL(0, completed);
+
+    s2.fireOnce();  // p2 and p3 complete the phase
+    TEST_ASSERT_EQUAL(3, completed);
+}
+
+}  // namespace exec
+
+TESTS_MAIN
@@ -0,0 +1,209 @@
+#include "coro/test.h"
+
+#include <exec/coro/Async.h>
+#include <exec/coro/ManualTask.h>
+#include <exec/coro/sync/BroadcastChannel.h>
+
+#include <utest/utest.h>
+
+namespace exec {
+
+struct t_broadcast_channel : t_coro {};
+
+TEST_F(t_broadcast_channel, every_subscriber_receives) {
+    BroadcastChannel<int, 4> c;
+    int received[2] = {0, 0};
+
+    auto subscriber = [&](int i) -> Async<> {
+        auto sub = c.subscribe();
+        for (;;) {
+            auto res = co_await sub.receive();
+            TEST_ASSERT_TRUE(res);
+            received[i] += *res;
+
+            if (*res == 0) {
+                co_return;
+            }
+        }
+    };
+
+    auto a = makeManualTask(subscriber(0));
+    auto b = makeManualTask(subscriber(1));
+
+    a.start();
+    b.start();
+
+    for (int v : {1, 2, 3, 0}) {
+        TEST_ASSERT_TRUE(c.trySend(v));
+    }
+
+    TEST_ASSERT_TRUE(a.done());
+    TEST_ASSERT_TRUE(b.done());
+    TEST_ASSERT_EQUAL(6, received[0]);
+    TEST_ASSERT_EQUAL(6, received[1]);
+}
+
+TEST_F(t_broadcast_channel, receivers_sharing_a_subscriber) {
+    BroadcastChannel<int, 4> c;
+    auto shared = c.subscribe();
+    auto other = c.subscribe();
+
+    auto receiver = [](BroadcastChannel<int, 4>::Subscriber* sub) -> Async<int> {
+        auto res = co_await sub->receive();
+        co_return *res;
+    };
+
+    // parked in this order: the second one cannot take the value taken by the first one
+    auto first = makeManualTask(receiver(&shared));
+    auto second = makeManualTask(receiver(&shared));
+    auto third = makeManualTask(receiver(&other));
+
+    first.start();
+    second.start();
+    third.start();
+
+    int v = 1;
+    TEST_ASSERT_TRUE(c.trySend(v));
+    TEST_ASSERT_TRUE(first.done());
+    TEST_ASSERT_FALSE(second.done());
+    TEST_ASSERT_TRUE(third.done());
+    TEST_ASSERT_EQUAL(1, *first.result());
+    TEST_ASSERT_EQUAL(1, *third.result());
+
+    v = 2;
+    TEST_ASSERT_TRUE(c.trySend(v));
+    TEST_ASSERT_TRUE(second.done());
+    TEST_ASSERT_EQUAL(2, *second.result());
+}
+
+TEST_F(t_broadcast_channel, only_values_after_subscribe) {
+    BroadcastChannel<int, 4> c;
+    int v = 1;
+
+    auto early = c.subscribe();
+    TEST_ASSERT_TRUE(c.trySend(v));
+
+    auto late = c.subscribe();
+    TEST_ASSERT_EQUAL(1, early.pending());
+    TEST_ASSERT_EQUAL(0, late.pending());
+    TEST_ASSERT_EQUAL(1, *early.tryReceive());
+    TEST_ASSERT_EQUAL(ErrCode::Exhausted, late.tryReceive().code());
+}
+
+TEST_F(t_broadcast_channel, lagged) {
+    BroadcastChannel<int, 4> c;
+    auto sub = c.subscribe();
+
+    for (int i = 0; i < 6; ++i) {
+        TEST_ASSERT_TRUE(c.trySend(i));
+    }
+
+    TEST_ASSERT_EQUAL(ErrCode::Lagged, sub.tryReceive().code());
+    TEST_ASSERT_EQUAL(2, sub.missed());
+
+    for (int i = 2; i < 6; ++i) {
+        TEST_ASSERT_EQUAL(i, *sub.tryReceive());
+    }
+
+    TEST_ASSERT_EQUAL(ErrCode::Exhausted, sub.tryReceive().code());
+}
+
+TEST_F(t_broadcast_channel, block_on_slowest) {
+    BroadcastChannel<int, 2, BroadcastPolicy::Block> c;
+    auto fast = c.subscribe();
+    auto slow = c.subscribe();
+
+    auto producer_body = [&]() -> Async<> {
+        for (int i = 0; i < 4; ++i) {
+            int v = i;
+            TEST_ASSERT_TRUE(co_await c.send(v));
+        }
+    };
+
+    auto producer = makeManualTask(producer_body());
+
+    producer.start();
+    TEST_ASSERT_FALSE(producer.done());  // the ring is full
+
+    TEST_ASSERT_EQUAL(0, *fast.tryReceive());
+    TEST_ASSERT_EQUAL(1, *fast.tryReceive());
+    TEST_ASSERT_FALSE(producer.done());  // slow has not received anything yet
+
+    TEST_ASSERT_EQUAL(0, *slow.tryReceive());
+    TEST_ASSERT_EQUAL(2, *fast.tryReceive());
+    TEST_ASSERT_FALSE(producer.done());
+
+    TEST_ASSERT_EQUAL(1, *slow.tryReceive());
+    TEST_ASSERT_TRUE(producer.done());
+
+    TEST_ASSERT_EQUAL(2, *slow.tryReceive());
+    TEST_ASSERT_EQUAL(3, *slow.tryReceive());
+    TEST_ASSERT_EQUAL(3, *fast.tryReceive());
+}
+
+TEST_F(t_broadcast_channel, unsubscribe_unblocks) {
+    BroadcastChannel<int, 2, BroadcastPolicy::Block> c;
+    auto fast = c.subscribe();
+
+    auto producer_body = [&]() -> Async<> {
+        for (int i = 0; i < 3; ++i) {
+            int v = i;
+            TEST_ASSERT_TRUE(co_await c.send(v));
+        }
+    };
+
+    auto producer = makeManualTask(producer_body());
+
+    {
+        auto slow = c.subscribe();
+
+        producer.start();
+        TEST_ASSERT_EQUAL(0, *fast.tryReceive());
+        TEST_ASSERT_FALSE(producer.done());
+    }
+
+    TEST_ASSERT_TRUE(producer.done());
+}
+
+TEST_F(t_broadcast_channel, cancel) {
+    BroadcastChannel<int, 2, BroadcastPolicy::Block> c;
+    auto sub = c.subscribe();
+    CancellationSignal recv_sig;
+    CancellationSignal send_sig;
+
+    auto receiver_body = [&]() -> Async<> {
+        auto res = co_await sub.receive().setCancellationSlot(recv_sig.slot());
+        TEST_ASSERT_EQUAL(ErrCode::Cancelled, res.code());
+    };
+
+    auto receiver = makeManualTask(receiver_body());
+    receiver.start();
+    TEST_ASSERT_FALSE(receiver.done());
+
+    recv_sig.emitSync();
+    TEST_ASSERT_TRUE(receiver.done());
+
+    int v = 1;
+    TEST_ASSERT_TRUE(c.trySend(v));
+    TEST_ASSERT_TRUE(c.trySend(v));
+
+    auto sender_body = [&]() -> Async<> {
+        int v = 3;
+        auto res = co_await c.send(v).setCancellationSlot(send_sig.slot());
+        TEST_ASSERT_EQUAL(ErrCode::Cancelled, res.code());
+    };
+
+    auto sender = makeManualTask(sender_body());
+    sender.start();
+    TEST_ASSERT_FALSE(sender.done());
+
+    send_sig.emitSync();
+    TEST_ASSERT_TRUE(sender.done());
+    TEST_ASSERT_EQUAL(1, *sub.tryReceive());
+    TEST_ASSERT_EQUAL(1, *sub.tryReceive());
+    TEST_ASSERT_EQUAL(ErrCode::Exhausted, sub.tryReceive().code());
+}
+
+}  // namespace exec
+
+TESTS_MAIN
@@ -0,0 +1,118 @@
+#include "coro/test.h"
+
+#include <exec/coro/Async.h>
+#include <exec/coro/ManualTask.h>
+#include <exec/coro/sync/ConditionVariable.h>
+#include <exec/coro/sync/Mutex.h>
+
+#include <utest/utest.h>
+
+namespace exec {
+
+struct t_condition_variable : t_coro {
+    Mutex m;
+    ConditionVariable cv;
+    int queued = 0;
+};
+
+namespace {
+
+Async<> consumer(Mutex& m, ConditionVariable& cv, int& queued) {
+    auto guard = co_await m.lock();
+    while (queued == 0) {
+        TEST_ASSERT_EQUAL(ErrCode::Success, co_await cv.wait(guard));
+        TEST_ASSERT_TRUE(guard);
+    }
+
+    --queued;
+}
+
+}  // namespace
+
+TEST_F(t_condition_variable, wait_releases_lock) {
+    auto c = makeManualTask(consumer(m, cv, queued));
+
+    c.start();
+    TEST_ASSERT_FALSE(c.done());
+
+    TEST_ASSERT_TRUE(m.try_lock());
+
+    queued = 1;
+    cv.notifyOne();
+    TEST_ASSERT_TRUE(c.done());
+}
+
+TEST_F(t_condition_variable, notify_one_hands_lock_over) {
+    auto c1 = makeManualTask(consumer(m, cv, queued));
+    auto c2 = makeManualTask(consumer(m, cv, queued));
+
+    c1.start();
+    c2.start();
+
+    {
+        auto guard = m.try_lock();
+        queued = 1;
+        cv.notifyOne();
+        TEST_ASSERT_FALSE(c1.done());  // waits for the lock
+    }
+
+    // the lock went straight to c1
+    TEST_ASSERT_TRUE(c1.done());
+    TEST_ASSERT_FALSE(c2.done());
+    TEST_ASSERT_EQUAL(0, queued);
+    TEST_ASSERT_TRUE(m.try_lock());
+
+    queued = 1;
+    cv.notifyOne();
+    TEST_ASSERT_TRUE(c2.done());
+}
+
+TEST_F(t_condition_variable, notify_all) {
+    auto c1 = makeManualTask(consumer(m, cv, queued));
+    auto c2 = makeManualTask(consumer(m, cv, queued));
+    auto c3 = makeManualTask(consumer(m, cv, queued));
+
+    c1.start();
+    c2.start();
+    c3.start();
+
+    {
+        auto guard = m.try_lock();
+        queued = 2;
+        cv.notifyAll();
+    }
+
+    // the third one checks the predicate and waits again
+    TEST_ASSERT_TRUE(c1.done());
+    TEST_ASSERT_TRUE(c2.done());
+    TEST_ASSERT_FALSE(c3.done());
+
+    queued = 1;
+    cv.notifyAll();  // without holding the lock
+    TEST_ASSERT_TRUE(c3.done());
+}
+
+TEST_F(t_condition_variable, cancel_reacquires_lock) {
+    CancellationSignal sig;
+
+    auto c = makeManualTask([](Mutex& m, ConditionVariable& cv, CancellationSlot slot) -> Async<> {
+        auto guard = co_await m.lock();
+        TEST_ASSERT_EQUAL(ErrCode::Cancelled, co_await cv.wait(guard).setCancellationSlot(slot));
+        TEST_ASSERT_TRUE(guard);
+    }(m, cv, sig.slot()));
+
+    c.start();
+
+    {
+        auto guard = m.try_lock();
+        sig.emitSync();
+        TEST_ASSERT_FALSE(c.done());  // waits for the lock
+    }
+
+    TEST_ASSERT_TRUE(c.done());
+    TEST_ASSERT_TRUE(m.try_lock());
+}
+
+}  // namespace exec
+
+TESTS_MAIN
@@ -0,0 +1,181 @@
+#include "coro/test.h"
+
+#include <exec/coro/Async.h>
+#include <exec/coro/ManualTask.h>
+#include <exec/coro/sync/IsrChannel.h>
+#include <exec/executor/SystemExecutor.h>
+
+#include <utest/utest.h>
+
+#if !defined(ARDUINO)
+#include <atomic>
+#include <thread>
+#endif
+
+namespace exec {
+
+struct t_isr_channel : t_coro {
+    OS os;
+    SystemExecutor executor;
+    IsrChannel<int, 4> c;
+};
+
+TEST_F(t_isr_channel, receive_available) {
+    TEST_ASSERT_TRUE(c.pushFromIsr(10));
+    TEST_ASSERT_TRUE(c.pushFromIsr(20));
+
+    auto coro_body = [&]() -> Async<> {
+        TEST_ASSERT_EQUAL(10, *co_await c.receive());
+        TEST_ASSERT_EQUAL(20, *co_await c.receive());
+    };
+
+    auto coro = makeManualTask(coro_body());
+
+    coro.start();
+    TEST_ASSERT_TRUE(coro.done());
+    TEST_ASSERT_TRUE(c.empty());
+}
+
+TEST_F(t_isr_channel, resumed_through_executor) {
+    auto coro_body = [&]() -> Async<> {
+        TEST_ASSERT_EQUAL(10, *co_await c.receive());
+        TEST_ASSERT_EQUAL(20, *co_await c.receive());
+    };
+
+    auto coro = makeManualTask(coro_body());
+
+    coro.start();
+    TEST_ASSERT_FALSE(coro.done());
+    TEST_ASSERT_EQUAL(ttime::Time::max().millis(), os.wakeAt().millis());
+
+    TEST_ASSERT_TRUE(c.pushFromIsr(10));
+    TEST_ASSERT_TRUE(c.pushFromIsr(20));
+    TEST_ASSERT_FALSE(coro.done());
+    TEST_ASSERT_EQUAL(ttime::mono::now().millis(), os.wakeAt().millis());
+
+    c.tick();  // posts the receiver
+    TEST_ASSERT_FALSE(coro.done());
+
+    executor.tick();
+    TEST_ASSERT_TRUE(coro.done());
+}
+
+TEST_F(t_isr_channel, overflow_counts_past_a_byte) {
+    for (int i = 0; i < 4; ++i) {
+        TEST_ASSERT_TRUE(c.pushFromIsr(i));
+    }
+
+    for (int i = 0; i < 200; ++i) {
+        TEST_ASSERT_FALSE(c.pushFromIsr(i));
+    }
+
+    c.tick();
+
+    for (int i = 0; i < 200; ++i) {
+        TEST_ASSERT_FALSE(c.pushFromIsr(i));
+    }
+
+    TEST_ASSERT_EQUAL(400, c.overflows());
+}
+
+TEST_F(t_isr_channel, overflow) {
+    for (int i = 0; i < 4; ++i) {
+        TEST_ASSERT_TRUE(c.pushFromIsr(i));
+    }
+
+    TEST_ASSERT_FALSE(c.pushFromIsr(4));
+    TEST_ASSERT_FALSE(c.pushFromIsr(5));
+    TEST_ASSERT_EQUAL(2, c.overflows());
+
+    for (int i = 0; i < 4; ++i) {
+        TEST_ASSERT_EQUAL(i, *c.tryReceive());
+    }
+
+    TEST_ASSERT_EQUAL(ErrCode::Exhausted, c.tryReceive().code());
+}
+
+TEST_F(t_isr_channel, cancelled) {
+    CancellationSignal sig;
+
+    auto coro_body = [&]() -> Async<> {
+        auto res = co_await c.receive().setCancellationSlot(sig.slot());
+        TEST_ASSERT_EQUAL(ErrCode::Cancelled, res.code());
+    };
+
+    auto coro = makeManualTask(coro_body());
+
+    coro.start();
+    TEST_ASSERT_TRUE(sig.hasHandler());
+
+    sig.emitSync();
+    TEST_ASSERT_TRUE(coro.done());
+
+    // nobody is parked anymore
+    TEST_ASSERT_TRUE(c.pushFromIsr(10));
+    TEST_ASSERT_EQUAL(ttime::Time::max().millis(), c.wakeAt().millis());
+}
+
+#if !defined(ARDUINO)
+
+// A real thread plays the interrupt handler
+TEST_F(t_isr_channel, stress) {
+    constexpr int Total = 100000;
+    constexpr int Burst = 64;
+    bool pushed_last = false;
+    int received = 0;
+    int last = -1;
+
+    auto consumer_body = [&]() -> Async<> {
+        for (;;) {
+            auto res = co_await c.receive();
+            TEST_ASSERT_TRUE(res);
+
+            if (*res == Total) {
+                co_return;
+            }
+
+            TEST_ASSERT_TRUE(*res > last);
+            last = *res;
+            ++received;
+        }
+    };
+
+    auto consumer = makeManualTask(consumer_body());
+
+    consumer.start();
+
+    std::thread isr([&] {
+        for (int i = 0; i < Total; ++i) {
+            (void)c.pushFromIsr(i);
+
+            // lets the consumer catch up, so that fewer than 256 drops go unseen
+            if (i % Burst == Burst - 1) {
+                while (!c.empty()) {
+                    std::this_thread::yield();
+                }
+            }
+        }
+
+        // the last value is sent once there is room for it, so that it is not counted
+        while (!c.empty()) {
+            std::this_thread::yield();
+        }
+
+        pushed_last = c.pushFromIsr(Total);
+    });
+
+    while (!consumer.done()) {
+        os.tick();
+    }
+
+    isr.join();
+    TEST_ASSERT_TRUE(pushed_last);
+    TEST_ASSERT_TRUE(c.overflows() > 0);
+    TEST_ASSERT_EQUAL(Total, received + static_cast<int>(c.overflows()));
+}
+
+#endif
+
+}  // namespace exec
+
+TESTS_MAIN
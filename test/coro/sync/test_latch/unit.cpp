@@ -0,0 +1,66 @@
+#include "coro/test.h"
+
+#include <exec/coro/Async.h>
+#include <exec/coro/ManualTask.h>
+#include <exec/coro/sync/Latch.h>
+
+#include <utest/utest.h>
+
+namespace exec {
+
+struct t_latch : t_coro {
+    Latch l{3};
+};
+
+namespace {
+
+Async<> waiter(Latch& l) {
+    auto errc = co_await l.wait();
+    TEST_ASSERT_EQUAL(ErrCode::Success, errc);
+}
+
+}  // namespace
+
+TEST_F(t_latch, releases_all_at_zero) {
+    auto w1 = makeManualTask(waiter(l));
+    auto w2 = makeManualTask(waiter(l));
+
+    w1.start();
+    w2.start();
+
+    l.countDown();
+    l.countDown();
+    TEST_ASSERT_FALSE(w1.done());
+    TEST_ASSERT_FALSE(l.ready());
+
+    l.countDown();
+    TEST_ASSERT_TRUE(l.ready());
+    TEST_ASSERT_TRUE(w1.done());
+    TEST_ASSERT_TRUE(w2.done());
+}
+
+TEST_F(t_latch, ready_does_not_suspend) {
+    l.countDown(3);
+
+    auto w = makeManualTask(waiter(l));
+    w.start();
+    TEST_ASSERT_TRUE(w.done());
+}
+
+TEST_F(t_latch, cancel) {
+    CancellationSignal sig;
+
+    auto w = makeManualTask([](Latch& l, CancellationSlot slot) -> Async<> {
+        TEST_ASSERT_EQUAL(ErrCode::Cancelled, co_await l.wait().setCancellationSlot(slot));
+    }(l, sig.slot()));
+
+    w.start();
+    sig.emitSync();
+    TEST_ASSERT_TRUE(w.done());
+
+    l.countDown(3);
+}
+
+}  // namespace exec
+
+TESTS_MAIN
@@ -11,8 +11,9 @@
 namespace exec {
 
 struct t_mpmc_channel : t_coro {
+    // The channel is passed as an argument: the lambda object does not outlive the call.
     auto receiver(int x) {
-        return makeManualTask([this](int x) -> Async<> {
+        return makeManualTask([](MPMCChannel<int, 2>& c, int x) -> Async<> {
             auto y = co_await c.receive();
 
             if (x == -1) {
@@ -21,14 +22,14 @@ struct t_mpmc_channel : t_coro {
                 TEST_ASSERT_TRUE(y);
                 TEST_ASSERT_EQUAL(x, *y);
             }
-        }(x));
+        }(c, x));
     }
 
     auto sender(int x, ErrCode expected) {
-        return makeManualTask([this](int x, ErrCode expected) mutable -> Async<> {
+        return makeManualTask([](MPMCChannel<int, 2>& c, int x, ErrCode expected) -> Async<> {
             auto ec = co_await c.send(x);
             TEST_ASSERT_EQUAL(expected, ec.code());
-        }(x, expected));
+        }(c, x, expected));
     }
 
     MPMCChannel<int, 2> c;
@@ -165,10 +166,12 @@ TEST_F(t_mpmc_channel, fifo_blocked_receivers) {
 TEST_F(t_mpmc_channel, receive_cancellation) {
     CancellationSignal sig;
 
-    auto coro = makeManualTask([&]() -> Async<> {
+    auto body = [&]() -> Async<> {
         auto res = co_await c.receive().setCancellationSlot(sig.slot());
         TEST_ASSERT_FALSE(res);
-    }());
+    };
+
+    auto coro = makeManualTask(body());
 
     TEST_ASSERT_FALSE(sig.hasHandler());
     coro.start();
@@ -184,11 +187,13 @@ TEST_F(t_mpmc_channel, send_cancellation) {
 
     auto s1 = sender(10, ErrCode::Success);
     auto s2 = sender(20, ErrCode::Success);
-    auto coro = makeManualTask([&]() -> Async<> {
+    auto body = [&]() -> Async<> {
         int x = 30;
         auto ec = co_await c.send(x).setCancellationSlot(sig.slot());
         TEST_ASSERT_EQUAL(ErrCode::Cancelled, ec.code());
-    }());
+    };
+
+    auto coro = makeManualTask(body());
 
     s1.start();
     s2.start();
@@ -202,6 +207,214 @@ TEST_F(t_mpmc_channel, send_cancellation) {
     TEST_ASSERT_TRUE(coro.done());
 }
 
+TEST_F(t_mpmc_channel, emplace) {
+    MPMCChannel<std::pair<int, int>, 1> pc;
+
+    auto body = [&]() -> Async<> {
+        TEST_ASSERT_TRUE(co_await pc.emplace(1, 2));
+
+        auto res = co_await pc.receive();
+        TEST_ASSERT_EQUAL(1, res->first);
+        TEST_ASSERT_EQUAL(2, res->second);
+    };
+
+    auto coro = makeManualTask(body());
+
+    coro.start();
+    TEST_ASSERT_TRUE(coro.done());
+}
+
+struct Constructed {
+    Constructed(int v, int* count) : v{v} { ++*count; }
+    int v;
+};
+
+Async<> emplaceTwo(MPMCChannel<Constructed, 1>& ch, int* count) {
+    auto first = co_await ch.emplace(1, count);
+    TEST_ASSERT_TRUE(first);
+
+    auto second = co_await ch.emplace(2, count);
+    TEST_ASSERT_TRUE(second);
+}
+
+Async<> receiveTwo(MPMCChannel<Constructed, 1>& ch) {
+    auto first = co_await ch.receive();
+    TEST_ASSERT_EQUAL(1, first->v);
+
+    auto second = co_await ch.receive();
+    TEST_ASSERT_EQUAL(2, second->v);
+}
+
+TEST_F(t_mpmc_channel, emplace_constructs_when_there_is_room) {
+    MPMCChannel<Constructed, 1> ch;
+    int count = 0;
+
+    auto s = makeManualTask(emplaceTwo(ch, &count));
+    s.start();
+    TEST_ASSERT_FALSE(s.done());
+    TEST_ASSERT_EQUAL(1, count);  // the second one waits for room with its arguments
+
+    auto r = makeManualTask(receiveTwo(ch));
+    r.start();
+    TEST_ASSERT_TRUE(r.done());
+    TEST_ASSERT_TRUE(s.done());
+    TEST_ASSERT_EQUAL(2, count);
+}
+
+TEST_F(t_mpmc_channel, emplace_to_parked_receiver) {
+    auto r = receiver(10);
+    r.start();
+    TEST_ASSERT_FALSE(r.done());
+
+    auto body = [&]() -> Async<> {  //
+        TEST_ASSERT_TRUE(co_await c.emplace(10));
+    };
+
+    auto coro = makeManualTask(body());
+
+    coro.start();
+    TEST_ASSERT_TRUE(coro.done());
+    TEST_ASSERT_TRUE(r.done());
+}
+
+TEST_F(t_mpmc_channel, send_many_wakes_all_receivers) {
+    auto r1 = receiver(10);
+    auto r2 = receiver(20);
+    auto r3 = receiver(30);
+
+    r1.start();
+    r2.start();
+    r3.start();
+
+    int values[] = {10, 20, 30, 40, 50};
+    auto body = [&]() -> Async<> {
+        TEST_ASSERT_EQUAL(5, co_await c.sendMany(values));
+    };
+
+    auto coro = makeManualTask(body());
+
+    coro.start();
+    TEST_ASSERT_TRUE(r1.done());
+    TEST_ASSERT_TRUE(r2.done());
+    TEST_ASSERT_TRUE(r3.done());
+    TEST_ASSERT_TRUE(coro.done());  // 40 and 50 are buffered
+
+    auto r4 = receiver(40);
+    auto r5 = receiver(50);
+    r4.start();
+    r5.start();
+    TEST_ASSERT_TRUE(r4.done());
+    TEST_ASSERT_TRUE(r5.done());
+}
+
+TEST_F(t_mpmc_channel, send_many_blocks_when_filled) {
+    int values[] = {10, 20, 30, 40, 50};
+    auto body = [&]() -> Async<> {
+        TEST_ASSERT_EQUAL(5, co_await c.sendMany(values));
+    };
+
+    auto coro = makeManualTask(body());
+
+    coro.start();
+    TEST_ASSERT_FALSE(coro.done());
+
+    int out[5] = {};
+    auto receiveBody = [&]() -> Async<> {
+        TEST_ASSERT_EQUAL(5, co_await c.receiveMany(out, 5, 5));
+    };
+
+    auto r = makeManualTask(receiveBody());
+
+    r.start();
+    TEST_ASSERT_TRUE(r.done());
+    TEST_ASSERT_TRUE(coro.done());
+
+    for (int i = 0; i < 5; ++i) {
+        TEST_ASSERT_EQUAL(values[i], out[i]);
+    }
+}
+
+TEST_F(t_mpmc_channel, receive_many_waits_for_min) {
+    int out[4] = {};
+    auto receiveBody = [&]() -> Async<> {
+        TEST_ASSERT_EQUAL(3, co_await c.receiveMany(out, 3, 4));
+    };
+
+    auto r = makeManualTask(receiveBody());
+
+    r.start();
+    TEST_ASSERT_FALSE(r.done());
+
+    auto s1 = sender(10, ErrCode::Success);
+    auto s2 = sender(20, ErrCode::Success);
+    auto s3 = sender(30, ErrCode::Success);
+
+    s1.start();
+    s2.start();
+    TEST_ASSERT_TRUE(s1.done());
+    TEST_ASSERT_TRUE(s2.done());
+    TEST_ASSERT_FALSE(r.done());
+
+    s3.start();
+    TEST_ASSERT_TRUE(s3.done());
+    TEST_ASSERT_TRUE(r.done());
+
+    TEST_ASSERT_EQUAL(10, out[0]);
+    TEST_ASSERT_EQUAL(20, out[1]);
+    TEST_ASSERT_EQUAL(30, out[2]);
+}
+
+TEST_F(t_mpmc_channel, receive_many_takes_up_to_max) {
+    int values[] = {10, 20, 30};
+    auto sendBody = [&]() -> Async<> {
+        TEST_ASSERT_EQUAL(3, co_await c.sendMany(values));
+    };
+
+    auto s = makeManualTask(sendBody());
+
+    s.start();
+    TEST_ASSERT_FALSE(s.done());  // 30 does not fit
+
+    int out[2] = {};
+    auto receiveBody = [&]() -> Async<> {
+        TEST_ASSERT_EQUAL(2, co_await c.receiveMany(out, 1, 2));
+    };
+
+    auto r = makeManualTask(receiveBody());
+
+    r.start();
+    TEST_ASSERT_TRUE(r.done());
+    TEST_ASSERT_TRUE(s.done());  // 30 is moved into the buffer
+    TEST_ASSERT_EQUAL(10, out[0]);
+    TEST_ASSERT_EQUAL(20, out[1]);
+
+    auto r3 = receiver(30);
+    r3.start();
+    TEST_ASSERT_TRUE(r3.done());
+}
+
+TEST_F(t_mpmc_channel, receive_many_cancellation) {
+    CancellationSignal sig;
+    int out[3] = {};
+
+    auto receiveBody = [&]() -> Async<> {
+        TEST_ASSERT_EQUAL(1, co_await c.receiveMany(out, 3, 3).setCancellationSlot(sig.slot()));
+    };
+
+    auto r = makeManualTask(receiveBody());
+
+    r.start();
+
+    auto s = sender(10, ErrCode::Success);
+    s.start();
+    TEST_ASSERT_TRUE(s.done());
+    TEST_ASSERT_FALSE(r.done());
+
+    sig.emitSync();
+    TEST_ASSERT_TRUE(r.done());
+    TEST_ASSERT_EQUAL(10, out[0]);
+}
+
 }  // namespace exec
 
 TESTS_MAIN
@@ -1,3 +1,4 @@
+#include "Executor.h"
 #include "coro/test.h"
 
 #include <exec/coro/Async.h>
@@ -7,12 +8,18 @@
 
 #include <utest/utest.h>
 
+#include <type_traits>
+#include <utility>
+
 namespace exec {
 
 struct t_mutex : t_coro {
     Mutex m;
 };
 
+// only the barging waiters get scheduled on the Executor
+static_assert(!std::is_base_of_v<Runnable, decltype(std::declval<Mutex&>().lock().operator co_await())>);
+
 TEST_F(t_mutex, try_lock) {
     {
         auto guard = m.try_lock();
@@ -174,6 +181,90 @@ TEST_F(t_mutex, lock_queue_cancelled) {
     TEST_ASSERT_TRUE(m.try_lock());
 }
 
+struct t_barging_mutex : t_coro {
+    t_barging_mutex() { setService<Executor>(&executor); }
+
+    using BargingMutex = BasicMutex<MutexPolicy::Barging, 2>;
+
+    test::Executor executor;
+    BargingMutex m;
+};
+
+TEST_F(t_barging_mutex, running_coroutine_barges) {
+    auto coro = makeManualTask([](BargingMutex& m) -> Async<> {
+        auto guard = co_await m.lock();
+        TEST_ASSERT_TRUE(guard);
+    }(m));
+
+    auto guard = m.try_lock();
+    coro.start();
+
+    std::move(guard).unlock();  // frees the lock and schedules the waiter
+    TEST_ASSERT_FALSE(coro.done());
+    TEST_ASSERT_EQUAL(1, executor.queued.size());
+
+    guard = m.try_lock();  // barges in
+    TEST_ASSERT_TRUE(guard);
+
+    executor.queued.popFront()->run();  // lost the lock, parked again
+    TEST_ASSERT_FALSE(coro.done());
+
+    std::move(guard).unlock();
+    executor.queued.popFront()->run();
+    TEST_ASSERT_TRUE(coro.done());
+}
+
+TEST_F(t_barging_mutex, starving_waiter_gets_handoff) {
+    auto coro = makeManualTask([](BargingMutex& m) -> Async<> {
+        auto guard = co_await m.lock();
+        TEST_ASSERT_TRUE(guard);
+    }(m));
+
+    auto guard = m.try_lock();
+    coro.start();
+
+    for (int i = 0; i < 2; ++i) {
+        std::move(guard).unlock();
+        guard = m.try_lock();
+        TEST_ASSERT_TRUE(guard);
+        executor.queued.popFront()->run();
+    }
+
+    // has lost twice, the lock goes straight to the waiter now
+    std::move(guard).unlock();
+    TEST_ASSERT_TRUE(coro.done());
+    TEST_ASSERT_TRUE(executor.queued.empty());
+}
+
+TEST_F(t_barging_mutex, cancelled_while_scheduled) {
+    CancellationSignal sig;
+
+    auto c1 = makeManualTask([](BargingMutex& m, CancellationSlot slot) -> Async<> {
+        auto guard = co_await m.lock().setCancellationSlot(slot);
+        TEST_ASSERT_FALSE(guard);
+    }(m, sig.slot()));
+
+    auto c2 = makeManualTask([](BargingMutex& m) -> Async<> {
+        auto guard = co_await m.lock();
+        TEST_ASSERT_TRUE(guard);
+    }(m));
+
+    auto guard = m.try_lock();
+    c1.start();
+    c2.start();
+
+    std::move(guard).unlock();  // schedules c1
+    sig.emitSync();
+    TEST_ASSERT_FALSE(c1.done());
+
+    executor.queued.popFront()->run();  // completes c1 and schedules c2
+    TEST_ASSERT_TRUE(c1.done());
+
+    executor.queued.popFront()->run();
+    TEST_ASSERT_TRUE(c2.done());
+    TEST_ASSERT_TRUE(m.try_lock());
+}
+
 }  // namespace exec
 
 TESTS_MAIN
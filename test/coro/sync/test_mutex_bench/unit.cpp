@@ -0,0 +1,121 @@
+#include "coro/test.h"
+
+#include <exec/coro/Async.h>
+#include <exec/coro/ManualTask.h>
+#include <exec/coro/sync/Mutex.h>
+#include <exec/coro/yield.h>
+#include <exec/executor/SystemExecutor.h>
+
+#include <utest/utest.h>
+
+// Define EXEC_BENCH_PRINT to print the measured lock rates
+#if defined(EXEC_BENCH_PRINT) && !defined(ARDUINO)
+#include <chrono>
+#include <cstdio>
+#endif
+
+namespace exec {
+
+namespace {
+
+constexpr int Workers = 4;
+constexpr int Iterations = 2000;
+constexpr int Relocks = 4;
+
+struct Stats {
+    int acquired = 0;
+    int switches = 0;  // acquisitions by a different worker than the previous one
+    int owner = -1;
+
+    void acquire(int id) {
+        ++acquired;
+
+        if (owner != id) {
+            ++switches;
+            owner = id;
+        }
+    }
+};
+
+// Keeps the lock across a suspension, so that the others get parked, then
+// takes it a few more times in a row for short critical sections.
+template <class M>
+Async<> worker(M& m, Stats& stats, int id) {
+    for (int i = 0; i < Iterations; ++i) {
+        {
+            auto guard = co_await m.lock();
+            stats.acquire(id);
+            co_await yield();
+        }
+
+        for (int r = 1; r < Relocks; ++r) {
+            auto guard = co_await m.lock();
+            stats.acquire(id);
+        }
+
+        co_await yield();
+    }
+}
+
+template <class M>
+void run(const char* name, Stats& stats) {
+    SystemExecutor executor;
+    M m;
+
+    ManualTask<Result<Unit>> tasks[Workers] = {
+        makeManualTask(worker(m, stats, 0)),
+        makeManualTask(worker(m, stats, 1)),
+        makeManualTask(worker(m, stats, 2)),
+        makeManualTask(worker(m, stats, 3)),
+    };
+
+#if defined(EXEC_BENCH_PRINT) && !defined(ARDUINO)
+    const auto start = std::chrono::steady_clock::now();
+#endif
+
+    for (auto& task : tasks) {
+        task.start();
+    }
+
+    auto done = [&] {
+        for (auto& task : tasks) {
+            if (!task.done()) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    while (!done()) {
+        executor.tick();
+    }
+
+#if defined(EXEC_BENCH_PRINT) && !defined(ARDUINO)
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    const double ms = std::chrono::duration<double, std::milli>(elapsed).count();
+    std::printf("%s: %.0f locks/ms, %d switches\n", name, stats.acquired / (ms > 0 ? ms : 1), stats.switches);
+#else
+    (void)name;
+#endif
+}
+
+}  // namespace
+
+TEST_F(t_coro, barging_keeps_the_lock_with_the_running_coroutine) {
+    Stats handoff;
+    Stats barging;
+
+    run<BasicMutex<MutexPolicy::Handoff>>("handoff", handoff);
+    run<BasicMutex<MutexPolicy::Barging>>("barging", barging);
+
+    TEST_ASSERT_EQUAL(Workers * Iterations * Relocks, handoff.acquired);
+    TEST_ASSERT_EQUAL(Workers * Iterations * Relocks, barging.acquired);
+
+    // handing over passes the lock on at every unlock with parked waiters,
+    // barging lets the unlocking coroutine take it again
+    TEST_ASSERT_LESS_THAN(handoff.switches / 2, barging.switches);
+}
+
+}  // namespace exec
+
+TESTS_MAIN
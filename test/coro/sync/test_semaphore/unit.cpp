@@ -151,6 +151,71 @@ TEST_F(t_semaphore, lock_queue_cancelled) {
     TEST_ASSERT_TRUE(c3.done());
 }
 
+TEST_F(t_semaphore, weighted) {
+    Semaphore budget{512};
+    TEST_ASSERT_TRUE(budget.tryAcquire(500));
+    TEST_ASSERT_FALSE(budget.tryAcquire(100));
+    TEST_ASSERT_TRUE(budget.tryAcquire(12));
+    budget.release(512);
+    TEST_ASSERT_TRUE(budget.tryAcquire(512));
+}
+
+TEST_F(t_semaphore, release_wakes_all_fitting) {
+    Semaphore budget{0};
+    int acquired = 0;
+
+    auto acquire = [](Semaphore& budget, int n, int& acquired) -> Async<> {
+        TEST_ASSERT_EQUAL(ErrCode::Success, co_await budget.acquire(n));
+        acquired += n;
+    };
+
+    auto c1 = makeManualTask(acquire(budget, 100, acquired));
+    auto c2 = makeManualTask(acquire(budget, 200, acquired));
+    auto c3 = makeManualTask(acquire(budget, 300, acquired));
+    auto c4 = makeManualTask(acquire(budget, 10, acquired));
+
+    c1.start();
+    c2.start();
+    c3.start();
+    c4.start();
+
+    budget.release(400);  // c1 and c2 fit, c3 does not and holds back c4
+    TEST_ASSERT_TRUE(c1.done());
+    TEST_ASSERT_TRUE(c2.done());
+    TEST_ASSERT_FALSE(c3.done());
+    TEST_ASSERT_FALSE(c4.done());
+    TEST_ASSERT_EQUAL(300, acquired);
+
+    // no barging in front of parked waiters
+    TEST_ASSERT_FALSE(budget.tryAcquire(10));
+
+    budget.release(210);
+    TEST_ASSERT_TRUE(c3.done());
+    TEST_ASSERT_TRUE(c4.done());
+    TEST_ASSERT_EQUAL(610, acquired);
+}
+
+TEST_F(t_semaphore, cancel_big_request_admits_next) {
+    Semaphore budget{100};
+    CancellationSignal sig;
+
+    auto big = makeManualTask([](Semaphore& budget, CancellationSlot slot) -> Async<> {
+        TEST_ASSERT_EQUAL(ErrCode::Cancelled, co_await budget.acquire(200).setCancellationSlot(slot));
+    }(budget, sig.slot()));
+
+    auto small = makeManualTask([](Semaphore& budget) -> Async<> {
+        TEST_ASSERT_EQUAL(ErrCode::Success, co_await budget.acquire(50));
+    }(budget));
+
+    big.start();
+    small.start();
+    TEST_ASSERT_FALSE(small.done());
+
+    sig.emitSync();
+    TEST_ASSERT_TRUE(big.done());
+    TEST_ASSERT_TRUE(small.done());
+}
+
 }  // namespace exec
 
 TESTS_MAIN
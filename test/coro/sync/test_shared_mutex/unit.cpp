@@ -0,0 +1,151 @@
+#include "coro/test.h"
+
+#include <exec/coro/Async.h>
+#include <exec/coro/ManualTask.h>
+#include <exec/coro/sync/Event.h>
+#include <exec/coro/sync/SharedMutex.h>
+
+#include <utest/utest.h>
+
+namespace exec {
+
+struct t_shared_mutex : t_coro {
+    SharedMutex m;
+};
+
+namespace {
+
+Async<> reader(SharedMutex& m, Event& release) {
+    auto guard = co_await m.lockShared();
+    TEST_ASSERT_TRUE(guard);
+    co_await release.wait();
+}
+
+Async<> writer(SharedMutex& m, Event& release) {
+    auto guard = co_await m.lock();
+    TEST_ASSERT_TRUE(guard);
+    co_await release.wait();
+}
+
+}  // namespace
+
+TEST_F(t_shared_mutex, try_lock) {
+    {
+        auto r1 = m.try_lock_shared();
+        auto r2 = m.try_lock_shared();
+        TEST_ASSERT_TRUE(r1);
+        TEST_ASSERT_TRUE(r2);
+        TEST_ASSERT_FALSE(m.try_lock());
+    }
+
+    {
+        auto w = m.try_lock();
+        TEST_ASSERT_TRUE(w);
+        TEST_ASSERT_FALSE(m.try_lock_shared());
+        TEST_ASSERT_FALSE(m.try_lock());
+    }
+
+    TEST_ASSERT_TRUE(m.try_lock());
+}
+
+TEST_F(t_shared_mutex, readers_share) {
+    Event release;
+    auto r1 = makeManualTask(reader(m, release));
+    auto r2 = makeManualTask(reader(m, release));
+
+    r1.start();
+    r2.start();
+    TEST_ASSERT_FALSE(m.try_lock());
+
+    release.set();
+    TEST_ASSERT_TRUE(r1.done());
+    TEST_ASSERT_TRUE(r2.done());
+    TEST_ASSERT_TRUE(m.try_lock());
+}
+
+TEST_F(t_shared_mutex, writer_preference) {
+    Event release_r1;
+    Event release_w;
+    Event release_r2;
+
+    auto r1 = makeManualTask(reader(m, release_r1));
+    auto w = makeManualTask(writer(m, release_w));
+    auto r2 = makeManualTask(reader(m, release_r2));
+
+    r1.start();
+    w.start();   // parked behind r1
+    r2.start();  // parked behind the writer although the lock is shared
+    TEST_ASSERT_FALSE(m.try_lock_shared());
+
+    release_r1.set();
+    TEST_ASSERT_TRUE(r1.done());
+    TEST_ASSERT_FALSE(w.done());  // owns the lock
+
+    release_r2.set();
+    TEST_ASSERT_FALSE(r2.done());  // still waits for the writer
+
+    release_w.set();
+    TEST_ASSERT_TRUE(w.done());
+    TEST_ASSERT_TRUE(r2.done());
+}
+
+TEST_F(t_shared_mutex, wakes_consecutive_readers) {
+    Event release_w;
+    Event release_r;
+    Event release_w2;
+
+    auto w = makeManualTask(writer(m, release_w));
+    auto r1 = makeManualTask(reader(m, release_r));
+    auto r2 = makeManualTask(reader(m, release_r));
+    auto w2 = makeManualTask(writer(m, release_w2));
+    auto r3 = makeManualTask(reader(m, release_r));
+
+    w.start();
+    r1.start();
+    r2.start();
+    w2.start();
+    r3.start();
+
+    release_w.set();  // r1 and r2 take the lock together, r3 waits behind w2
+    TEST_ASSERT_TRUE(w.done());
+
+    release_r.set();
+    TEST_ASSERT_TRUE(r1.done());
+    TEST_ASSERT_TRUE(r2.done());
+    TEST_ASSERT_FALSE(r3.done());
+    TEST_ASSERT_FALSE(w2.done());
+
+    release_w2.set();
+    TEST_ASSERT_TRUE(w2.done());
+    TEST_ASSERT_TRUE(r3.done());
+    TEST_ASSERT_TRUE(m.try_lock());
+}
+
+TEST_F(t_shared_mutex, cancel_writer_admits_readers) {
+    Event release_r;
+    CancellationSignal sig;
+
+    auto r1 = makeManualTask(reader(m, release_r));
+    auto w = makeManualTask([](SharedMutex& m, CancellationSlot slot) -> Async<> {
+        auto guard = co_await m.lock().setCancellationSlot(slot);
+        TEST_ASSERT_FALSE(guard);
+    }(m, sig.slot()));
+    auto r2 = makeManualTask(reader(m, release_r));
+
+    r1.start();
+    w.start();
+    r2.start();
+    TEST_ASSERT_FALSE(r2.done());
+
+    sig.emitSync();
+    TEST_ASSERT_TRUE(w.done());
+
+    release_r.set();
+    TEST_ASSERT_TRUE(r1.done());
+    TEST_ASSERT_TRUE(r2.done());
+    TEST_ASSERT_TRUE(m.try_lock());
+}
+
+}  // namespace exec
+
+TESTS_MAIN
@@ -0,0 +1,91 @@
+#include "coro/test.h"
+
+#include <exec/coro/Async.h>
+#include <exec/coro/ManualTask.h>
+#include <exec/coro/sync/Event.h>
+#include <exec/coro/sync/WaitGroup.h>
+
+#include <utest/utest.h>
+
+namespace exec {
+
+struct t_wait_group : t_coro {
+    WaitGroup wg;
+};
+
+namespace {
+
+Async<> worker(WaitGroup& wg, Event& finish) {
+    (void)co_await finish.wait();
+    wg.done();
+}
+
+Async<> waiter(WaitGroup& wg) {
+    auto errc = co_await wg.wait();
+    TEST_ASSERT_EQUAL(ErrCode::Success, errc);
+}
+
+}  // namespace
+
+TEST_F(t_wait_group, empty_does_not_suspend) {
+    auto w = makeManualTask(waiter(wg));
+    w.start();
+    TEST_ASSERT_TRUE(w.done());
+}
+
+TEST_F(t_wait_group, waits_for_all) {
+    Event f1, f2;
+
+    wg.add(2);
+    auto a = makeManualTask(worker(wg, f1));
+    auto b = makeManualTask(worker(wg, f2));
+    auto w = makeManualTask(waiter(wg));
+
+    a.start();
+    b.start();
+    w.start();
+
+    f1.set();
+    TEST_ASSERT_EQUAL(1, wg.count());
+    TEST_ASSERT_FALSE(w.done());
+
+    f2.set();
+    TEST_ASSERT_TRUE(w.done());
+}
+
+TEST_F(t_wait_group, reusable) {
+    Event f;
+
+    for (int round = 0; round < 2; ++round) {
+        f.clear();
+        wg.add();
+        auto a = makeManualTask(worker(wg, f));
+        auto w = makeManualTask(waiter(wg));
+
+        a.start();
+        w.start();
+        TEST_ASSERT_FALSE(w.done());
+
+        f.set();
+        TEST_ASSERT_TRUE(w.done());
+    }
+}
+
+TEST_F(t_wait_group, cancel) {
+    CancellationSignal sig;
+
+    wg.add();
+    auto w = makeManualTask([](WaitGroup& wg, CancellationSlot slot) -> Async<> {
+        TEST_ASSERT_EQUAL(ErrCode::Cancelled, co_await wg.wait().setCancellationSlot(slot));
+    }(wg, sig.slot()));
+
+    w.start();
+    sig.emitSync();
+    TEST_ASSERT_TRUE(w.done());
+
+    wg.done();
+}
+
+}  // namespace exec
+
+TESTS_MAIN
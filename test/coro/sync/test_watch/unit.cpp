@@ -0,0 +1,104 @@
+#include "coro/test.h"
+
+#include <exec/coro/Async.h>
+#include <exec/coro/ManualTask.h>
+#include <exec/coro/sync/Watch.h>
+
+#include <utest/utest.h>
+
+namespace exec {
+
+struct t_watch : t_coro {
+    Watch<int> w;
+};
+
+TEST_F(t_watch, ready_when_version_differs) {
+    w.set(10);
+
+    auto coro_body = [&]() -> Async<> {
+        auto version = co_await w.changed(0);
+        TEST_ASSERT_EQUAL(1, *version);
+        TEST_ASSERT_EQUAL(10, w.get());
+    };
+
+    auto coro = makeManualTask(coro_body());
+
+    coro.start();
+    TEST_ASSERT_TRUE(coro.done());
+}
+
+TEST_F(t_watch, wakes_all_readers) {
+    int seen[2] = {0, 0};
+
+    auto reader = [&](int i) -> Async<> {
+        Watch<int>::Version version = w.version();
+        for (;;) {
+            auto res = co_await w.changed(version);
+            version = *res;
+            seen[i] = w.get();
+
+            if (w.get() == 3) {
+                co_return;
+            }
+        }
+    };
+
+    auto a = makeManualTask(reader(0));
+    auto b = makeManualTask(reader(1));
+
+    a.start();
+    b.start();
+    TEST_ASSERT_FALSE(a.done());
+    TEST_ASSERT_FALSE(b.done());
+
+    w.set(1);
+    TEST_ASSERT_EQUAL(1, seen[0]);
+    TEST_ASSERT_EQUAL(1, seen[1]);
+
+    w.update([](int& v) { v = 3; });
+    TEST_ASSERT_TRUE(a.done());
+    TEST_ASSERT_TRUE(b.done());
+    TEST_ASSERT_EQUAL(3, seen[0]);
+    TEST_ASSERT_EQUAL(3, seen[1]);
+    TEST_ASSERT_EQUAL(2, w.version());
+}
+
+TEST_F(t_watch, slow_reader_skips_values) {
+    w.set(1);
+    w.set(2);
+    w.set(3);
+
+    auto coro_body = [&]() -> Async<> {
+        auto version = co_await w.changed(1);
+        TEST_ASSERT_EQUAL(3, *version);
+        TEST_ASSERT_EQUAL(3, w.get());
+    };
+
+    auto coro = makeManualTask(coro_body());
+
+    coro.start();
+    TEST_ASSERT_TRUE(coro.done());
+}
+
+TEST_F(t_watch, cancel) {
+    CancellationSignal sig;
+
+    auto coro_body = [&]() -> Async<> {
+        auto res = co_await w.changed(w.version()).setCancellationSlot(sig.slot());
+        TEST_ASSERT_EQUAL(ErrCode::Cancelled, res.code());
+    };
+
+    auto coro = makeManualTask(coro_body());
+
+    coro.start();
+    TEST_ASSERT_FALSE(coro.done());
+
+    sig.emitSync();
+    TEST_ASSERT_TRUE(coro.done());
+
+    w.set(1);
+}
+
+}  // namespace exec
+
+TESTS_MAIN
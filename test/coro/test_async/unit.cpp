@@ -297,6 +297,118 @@ TEST_F(t_async, multiple_suspension_points) {
     TEST_ASSERT_EQUAL(3, i);
 }
 
+TEST_F(t_async, eager_completes_inline) {
+    int sum = 0;
+
+    auto task = [&](int x) -> Async<int> {  //
+        co_return x;
+    };
+
+    // the caller never suspends, the native stack stays flat however long the loop is
+    auto main = [&]() -> Async<> {
+        for (int i = 0; i < 100000; ++i) {
+            sum += *co_await task(1).eager();
+        }
+    };
+
+    auto t = makeManualTask(main());
+    t.start();
+    TEST_ASSERT_TRUE(t.done());
+    TEST_ASSERT_EQUAL(100000, sum);
+}
+
+TEST_F(t_async, eager_suspends) {
+    Event event;
+    bool started = false;
+
+    auto task = [&]() -> Async<int> {
+        started = true;
+        (void)co_await event.wait();
+        co_return 10;
+    };
+    auto main = [&]() -> Async<int> {
+        auto x = co_await task().eager();
+        co_return *x + 1;
+    };
+
+    auto t = makeManualTask(main());
+    t.start();
+    TEST_ASSERT_TRUE(started);
+    TEST_ASSERT_FALSE(t.done());
+
+    event.fireOnce();
+    TEST_ASSERT_TRUE(t.done());
+    TEST_ASSERT_EQUAL(11, *t.result());
+}
+
+TEST_F(t_async, eager_cancellation) {
+    Event event;
+    CancellationSignal sig;
+
+    auto task = [&]() -> Async<> {
+        auto ec = co_await event.wait();
+        TEST_ASSERT_EQUAL(ErrCode::Cancelled, ec);
+    };
+    auto main = [&]() -> Async<> {
+        (void)co_await task().eager();
+        (void)co_await task().eager();  // finalizes here without starting the task
+        TEST_FAIL_MESSAGE("should not be reached");
+    };
+
+    auto t = makeManualTask(main().setCancellationSlot(sig.slot()));
+    t.start();
+    TEST_ASSERT_FALSE(t.done());
+
+    sig.emitSync();
+    TEST_ASSERT_TRUE(t.done());
+    TEST_ASSERT_EQUAL(ErrCode::Cancelled, t.result().code());
+}
+
+// nested deeper than EXEC_EAGER_DEPTH, the deeper children start lazily
+Async<int> eagerChain(int depth, Event* event) {
+    if (depth == 0) {
+        (void)co_await event->wait();
+        co_return 0;
+    }
+
+    auto x = co_await eagerChain(depth - 1, event).eager();
+    co_return *x + 1;
+}
+
+TEST_F(t_async, eager_depth) {
+    Event event;
+    bool ready = GENERATE(true, false);
+    if (ready) {
+        event.set();
+    }
+
+    auto t = makeManualTask(eagerChain(EXEC_EAGER_DEPTH * 2, &event));
+    t.start();
+    TEST_ASSERT_EQUAL(ready, t.done());
+
+    event.set();
+    TEST_ASSERT_TRUE(t.done());
+    TEST_ASSERT_EQUAL(EXEC_EAGER_DEPTH * 2, *t.result());
+    TEST_ASSERT_EQUAL(0, detail::eagerDepth);
+}
+
+TEST_F(t_async, eager_allocation_failure) {
+    auto task = [&]() -> Async<int> {  //
+        co_return 10;
+    };
+    auto main = [&]() -> Async<> {  //
+        auto x = co_await task().eager();
+        TEST_ASSERT_EQUAL(ErrCode::OutOfMemory, x.code());
+    };
+
+    auto t = makeManualTask(main());
+
+    fail_allocation = true;
+    t.start();
+    TEST_ASSERT_TRUE(t.done());
+    fail_allocation = false;
+}
+
 }  // namespace exec
 
 TESTS_MAIN
@@ -0,0 +1,121 @@
+#include <exec/coro/Async.h>
+#include <exec/coro/ManualTask.h>
+#include <exec/coro/profile.h>
+#include <exec/coro/sync/Event.h>
+
+#include "coro/test.h"
+
+#include <time/config.h>
+#include <time/mono.h>
+#include <utest/utest.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace exec {
+
+struct t_await_profile : t_coro {
+    t_await_profile() {
+#if EXEC_AWAIT_PROFILE
+        profile::resetAwaitSites();
+#endif
+    }
+};
+
+#if EXEC_AWAIT_PROFILE
+
+constexpr uint_least32_t WaitLine = __LINE__ + 3;
+
+Async<> waitTwice(Event* first, Event* second) {
+    co_await first->wait();
+    co_await second->wait();
+}
+
+TEST_F(t_await_profile, suspended_time_per_site) {
+    Event first;
+    Event second;
+
+    auto task = makeManualTask(waitTwice(&first, &second));
+    task.start();
+
+    ttime::mono::advance(ttime::Duration(5));
+    first.set();
+    ttime::mono::advance(ttime::Duration(20));
+    second.set();
+    TEST_ASSERT_TRUE(task.done());
+
+    TEST_ASSERT_EQUAL(2, profile::awaitSiteCount());
+
+    const auto& a = profile::awaitSites()[0];
+    TEST_ASSERT_EQUAL(WaitLine, a.line);
+    TEST_ASSERT_TRUE(std::strstr(a.file, "unit.cpp") != nullptr);
+    TEST_ASSERT_EQUAL(1, a.count);
+    TEST_ASSERT_EQUAL(5000, a.totalUs);
+    TEST_ASSERT_EQUAL(5000, a.maxUs);
+
+    const auto& b = profile::awaitSites()[1];
+    TEST_ASSERT_EQUAL(WaitLine + 1, b.line);
+    TEST_ASSERT_EQUAL(20000, b.totalUs);
+
+    SECTION("print longest first") {
+        std::vector<std::string> lines;
+        profile::printAwaitSites([&lines](const char* l) { lines.emplace_back(l); });
+
+        TEST_ASSERT_EQUAL(2, lines.size());
+        const auto expected = "unit.cpp:" + std::to_string(WaitLine + 1) + " count=1 total=20ms";
+        TEST_ASSERT_EQUAL(0, lines[0].find(expected));
+    }
+}
+
+TEST_F(t_await_profile, ready_awaits_are_not_counted) {
+    Event first;
+    Event second;
+    first.set();
+
+    auto task = makeManualTask(waitTwice(&first, &second));
+    task.start();
+    ttime::mono::advance(ttime::Duration(3));
+    second.set();
+
+    TEST_ASSERT_EQUAL(1, profile::awaitSiteCount());
+    TEST_ASSERT_EQUAL(WaitLine + 1, profile::awaitSites()[0].line);
+}
+
+Async<> waitOn(Event* event) {
+    co_await event->wait();
+}
+
+TEST_F(t_await_profile, aggregates_per_site) {
+    Event event;
+    auto a = makeManualTask(waitOn(&event));
+    auto b = makeManualTask(waitOn(&event));
+    auto c = makeManualTask(waitOn(&event));
+    a.start();
+    b.start();
+    c.start();
+
+    ttime::mono::advance(ttime::Duration(1));
+    event.set();
+
+    TEST_ASSERT_EQUAL(1, profile::awaitSiteCount());
+    TEST_ASSERT_EQUAL(3, profile::awaitSites()[0].count);
+    TEST_ASSERT_EQUAL(3000, profile::awaitSites()[0].totalUs);
+
+    SECTION("reset") {
+        profile::resetAwaitSites();
+        TEST_ASSERT_EQUAL(0, profile::awaitSiteCount());
+    }
+}
+
+#else
+
+TEST_F(t_await_profile, disabled) {
+    static_assert(sizeof(detail::SuspendPoint) == 1);
+}
+
+#endif
+
+}  // namespace exec
+
+TESTS_MAIN
@@ -0,0 +1,125 @@
+#include "coro/test.h"
+
+#include <exec/coro/Async.h>
+#include <exec/coro/block.h>
+#include <exec/coro/sync/Event.h>
+#include <exec/coro/wait.h>
+#include <exec/coro/yield.h>
+#include <exec/executor/SystemExecutor.h>
+
+#include <utest/utest.h>
+
+void setUp() {
+    static_assert(TIME_MANUAL, "manual time is expected for tests");
+    ttime::mono::set(ttime::Time());
+}
+
+namespace exec {
+
+struct t_block : t_coro {
+    OS os;
+    SystemExecutor executor;
+    HeapTimerService<2> timers;
+};
+
+TEST_F(t_block, ready) {
+    auto res = blockOn(os, []() -> Async<int> { co_return 10; }());
+    TEST_ASSERT_TRUE(res);
+    TEST_ASSERT_EQUAL(10, *res);
+}
+
+TEST_F(t_block, runs_executor) {
+    auto coro = []() -> Async<int> {
+        for (int i = 0; i < 3; ++i) {
+            co_await yield();
+        }
+
+        co_return 20;
+    };
+
+    auto res = blockOn(os, coro());
+    TEST_ASSERT_EQUAL(20, *res);
+    TEST_ASSERT_EQUAL(0, ttime::mono::now().millis());
+}
+
+TEST_F(t_block, sleeps_until_timers) {
+    auto coro = []() -> Async<int> {
+        TEST_ASSERT_EQUAL(ErrCode::Success, co_await wait(ttime::Duration(100)));
+        TEST_ASSERT_EQUAL(ErrCode::Success, co_await wait(ttime::Duration(50)));
+        co_return 30;
+    };
+
+    auto res = blockOn(os, coro());
+    TEST_ASSERT_EQUAL(30, *res);
+
+    // manual time jumps straight to the timers
+    TEST_ASSERT_EQUAL(150, ttime::mono::now().millis());
+}
+
+TEST_F(t_block, deadlock) {
+    Event e;
+    bool cancelled = false;
+
+    auto coro = [&]() -> Async<int> {
+        auto ec = co_await e.wait();
+        cancelled = ec == ErrCode::Cancelled;
+        co_return 40;
+    };
+
+    auto res = blockOn(os, coro());
+    TEST_ASSERT_EQUAL(ErrCode::Deadlock, res.code());
+    TEST_ASSERT_TRUE(cancelled);
+}
+
+// Completes on the executor once cancelled
+struct SlowCancel {
+    struct Awaiter : Runnable, CancellationHandler {
+        Awaiter(CancellationSlot slot, bool* resumed) : slot{slot}, resumed{resumed} {}
+
+        bool await_ready() const { return false; }
+
+        void await_suspend(std::coroutine_handle<> caller) {
+            this->caller = caller;
+            slot.installIfConnected(this);
+        }
+
+        ErrCode await_resume() const { return ErrCode::Cancelled; }
+
+        std::coroutine_handle<> cancel() override {
+            service<Executor>()->post(this);
+            return std::noop_coroutine();
+        }
+
+        void run() override {
+            *resumed = true;
+            caller.resume();
+        }
+
+        CancellationSlot slot;
+        bool* resumed;
+        std::coroutine_handle<> caller;
+    };
+
+    // CancellableAwaitable
+    SlowCancel& setCancellationSlot(CancellationSlot s) {
+        slot = s;
+        return *this;
+    }
+
+    Awaiter operator co_await() { return Awaiter{slot, resumed}; }
+
+    CancellationSlot slot{};
+    bool* resumed;
+};
+
+TEST_F(t_block, deadlock_unwinds_cancellation) {
+    bool resumed = false;
+
+    auto res = blockOn(os, SlowCancel{.resumed = &resumed});
+    TEST_ASSERT_EQUAL(ErrCode::Deadlock, res.code());
+    TEST_ASSERT_TRUE(resumed);
+}
+
+}  // namespace exec
+
+TESTS_MAIN
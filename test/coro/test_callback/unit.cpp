@@ -0,0 +1,62 @@
+#include "coro/test.h"
+
+#include <exec/coro/Async.h>
+#include <exec/coro/ManualTask.h>
+#include <exec/coro/callback.h>
+
+#include <utest/utest.h>
+
+namespace exec {
+
+struct IntCallback {
+    virtual ~IntCallback() = default;
+    virtual void run(int value) = 0;
+};
+
+struct IntService {
+    using CallbackArgType = int;
+    using CallbackType = IntCallback;
+
+    void setCallback(IntCallback* c) { callback = c; }
+
+    IntCallback* callback = nullptr;
+};
+
+struct t_callback : t_coro {
+    IntService service;
+};
+
+TEST_F(t_callback, value) {
+    auto coro = makeManualTask([](IntService* service) -> Async<int> {
+        co_return co_await waitCallback(*service);
+    }(&service));
+
+    coro.start();
+    TEST_ASSERT_FALSE(coro.done());
+    TEST_ASSERT_NOT_NULL(service.callback);
+
+    service.callback->run(42);
+    TEST_ASSERT_TRUE(coro.done());
+    TEST_ASSERT_EQUAL(42, *coro.result());
+    TEST_ASSERT_NULL(service.callback);
+}
+
+TEST_F(t_callback, cancelled) {
+    CancellationSignal sig;
+
+    auto coro = makeManualTask([](IntService* service, CancellationSignal* sig) -> Async<int> {
+        co_return co_await waitCallback(*service).setCancellationSlot(sig->slot());
+    }(&service, &sig));
+
+    coro.start();
+    TEST_ASSERT_NOT_NULL(service.callback);
+
+    sig.emitSync();
+    TEST_ASSERT_TRUE(coro.done());
+    TEST_ASSERT_EQUAL(ErrCode::Cancelled, coro.result().code());
+    TEST_ASSERT_NULL(service.callback);
+}
+
+}  // namespace exec
+
+TESTS_MAIN
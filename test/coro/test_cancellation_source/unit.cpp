@@ -0,0 +1,132 @@
+#include "coro/test.h"
+
+#include <exec/coro/Async.h>
+#include <exec/coro/ManualTask.h>
+#include <exec/coro/cancel.h>
+#include <exec/coro/sync/Event.h>
+
+#include <memory>
+
+#include <utest/utest.h>
+
+namespace exec {
+
+struct t_cancellation_source : t_coro {
+    CancellationSource source;
+    Event event;
+
+    // an operation owning its registration
+    Async<bool> waitEvent() {
+        CancellationRegistration reg;
+        co_return co_await event.wait().setCancellationSlot(reg.connect(source)) == ErrCode::Cancelled;
+    }
+};
+
+TEST_F(t_cancellation_source, fan_out) {
+    auto c1 = makeManualTask(waitEvent());
+    auto c2 = makeManualTask(waitEvent());
+    auto c3 = makeManualTask(waitEvent());
+
+    c1.start();
+    c2.start();
+    c3.start();
+    TEST_ASSERT_TRUE(source.hasRegistrations());
+    TEST_ASSERT_FALSE(source.cancelRequested());
+
+    source.requestCancel();
+    TEST_ASSERT_TRUE(source.cancelRequested());
+    TEST_ASSERT_FALSE(source.hasRegistrations());
+
+    TEST_ASSERT_TRUE(c1.done());
+    TEST_ASSERT_TRUE(c2.done());
+    TEST_ASSERT_TRUE(c3.done());
+    TEST_ASSERT_TRUE(*c1.result());
+    TEST_ASSERT_TRUE(*c2.result());
+    TEST_ASSERT_TRUE(*c3.result());
+}
+
+TEST_F(t_cancellation_source, finished_operations_disconnect) {
+    auto c1 = makeManualTask(waitEvent());
+    auto c2 = makeManualTask(waitEvent());
+
+    c1.start();
+    event.fireOnce();
+    TEST_ASSERT_TRUE(c1.done());
+    TEST_ASSERT_FALSE(*c1.result());
+    TEST_ASSERT_FALSE(source.hasRegistrations());
+
+    c2.start();
+    source.requestCancel();
+    TEST_ASSERT_TRUE(c2.done());
+    TEST_ASSERT_TRUE(*c2.result());
+}
+
+TEST_F(t_cancellation_source, disconnect_while_cancelling) {
+    CancellationRegistration other;
+    Event otherEvent;
+
+    // the first cancelled operation disconnects the second one and lets it finish
+    auto c1 = makeManualTask([](t_cancellation_source* self, CancellationRegistration* other,
+                                 Event* otherEvent) -> Async<bool> {
+        CancellationRegistration reg;
+        auto ec = co_await self->event.wait().setCancellationSlot(reg.connect(self->source));
+        other->disconnect();
+        otherEvent->set();
+        co_return ec == ErrCode::Cancelled;
+    }(this, &other, &otherEvent));
+    auto c2 = makeManualTask([](t_cancellation_source* self, CancellationRegistration* other,
+                                 Event* otherEvent) -> Async<bool> {
+        co_return co_await otherEvent->wait().setCancellationSlot(other->connect(self->source)) ==
+            ErrCode::Cancelled;
+    }(this, &other, &otherEvent));
+
+    c1.start();
+    c2.start();
+
+    source.requestCancel();
+    TEST_ASSERT_TRUE(c1.done());
+    TEST_ASSERT_TRUE(c2.done());
+    TEST_ASSERT_TRUE(*c1.result());
+    TEST_ASSERT_FALSE(*c2.result());
+}
+
+TEST_F(t_cancellation_source, registration_reuse) {
+    CancellationRegistration reg;
+
+    auto coro = makeManualTask(
+        [](t_cancellation_source* self, CancellationRegistration* reg) -> Async<bool> {
+            auto ec = co_await self->event.wait().setCancellationSlot(reg->connect(self->source));
+            if (ec != ErrCode::Cancelled) {
+                co_return false;
+            }
+
+            // connected again after the request, not cancelled by it
+            TEST_ASSERT_TRUE(self->source.cancelRequested());
+            co_return co_await self->event.wait().setCancellationSlot(
+                          reg->connect(self->source)) == ErrCode::Cancelled;
+        }(this, &reg));
+
+    coro.start();
+    source.requestCancel();
+    TEST_ASSERT_FALSE(coro.done());
+    TEST_ASSERT_TRUE(reg.isConnected());
+
+    source.requestCancel();
+    TEST_ASSERT_TRUE(coro.done());
+    TEST_ASSERT_TRUE(*coro.result());
+    TEST_ASSERT_FALSE(reg.isConnected());
+}
+
+TEST_F(t_cancellation_source, destroyed_source) {
+    auto reg = std::make_unique<CancellationRegistration>();
+    {
+        CancellationSource s;
+        (void)reg->connect(s);
+        TEST_ASSERT_TRUE(reg->isConnected());
+    }
+    TEST_ASSERT_FALSE(reg->isConnected());
+}
+
+}  // namespace exec
+
+TESTS_MAIN
@@ -61,6 +61,26 @@ TEST_F(t_defer, exhausted) {
     TEST_ASSERT_TRUE(coro.done());
 }
 
+TEST_F(t_defer, cancelled) {
+    HeapDeferService<1> service;
+    CancellationSignal sig;
+
+    auto body = [&]() -> Async<> {
+        auto errc = co_await defer(ttime::Duration(10000)).setCancellationSlot(sig.slot());
+        TEST_ASSERT_EQUAL(ErrCode::Cancelled, errc);
+    };
+    auto coro = makeManualTask(body());
+
+    coro.start();
+    TEST_ASSERT_EQUAL(1, service.size());
+
+    // completes without waiting for the deadline
+    sig.emitSync();
+    TEST_ASSERT_TRUE(coro.done());
+    TEST_ASSERT_EQUAL(0, service.size());
+    TEST_ASSERT_EQUAL(ttime::Time::max().millis(), service.wakeAt().millis());
+}
+
 }  // namespace exec
 
 TESTS_MAIN
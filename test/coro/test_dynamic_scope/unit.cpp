@@ -254,6 +254,143 @@ TEST_F(t_coro, add_recursively) {
     TEST_ASSERT_EQUAL(0, scope.size());
 }
 
+TEST_F(t_coro, try_add_limited) {
+    DynamicScope scope(2);
+    Event e;
+
+    TEST_ASSERT_TRUE(scope.tryAdd(e.wait()));
+    TEST_ASSERT_TRUE(scope.tryAdd(e.wait()));
+    TEST_ASSERT_FALSE(scope.tryAdd(e.wait()));
+    TEST_ASSERT_TRUE(scope.full());
+
+    e.fireOnce();
+    TEST_ASSERT_EQUAL(0, scope.size());
+    TEST_ASSERT_FALSE(scope.full());
+}
+
+TEST_F(t_coro, add_when_ready) {
+    DynamicScope scope(2);
+    Event e;
+    int added = 0;
+
+    auto producer = [&]() -> Async<> {
+        for (int i = 0; i < 5; ++i) {
+            TEST_ASSERT_EQUAL(ErrCode::Success, co_await scope.addWhenReady(e.wait()));
+            ++added;
+        }
+
+        co_await scope.join();
+    };
+
+    auto m = makeManualTask(producer());
+
+    m.start();
+    TEST_ASSERT_EQUAL(2, added);
+    TEST_ASSERT_EQUAL(2, scope.size());
+
+    // Each completed task lets the producer add one more
+    e.fireOnce();
+    TEST_ASSERT_EQUAL(4, added);
+    TEST_ASSERT_EQUAL(2, scope.size());
+
+    e.fireOnce();
+    TEST_ASSERT_EQUAL(5, added);
+    TEST_ASSERT_EQUAL(1, scope.size());
+    TEST_ASSERT_FALSE(m.done());
+
+    e.fireOnce();
+    TEST_ASSERT_EQUAL(0, scope.size());
+    TEST_ASSERT_TRUE(m.done());
+}
+
+TEST_F(t_coro, add_when_ready_fifo) {
+    DynamicScope scope(1);
+    Event e1, e2;
+    int order = 0;
+
+    auto producer = [&](int expected) -> Async<> {
+        TEST_ASSERT_EQUAL(ErrCode::Success, co_await scope.addWhenReady(e2.wait()));
+        TEST_ASSERT_EQUAL(expected, order++);
+    };
+
+    scope.add(e1.wait());
+
+    auto p1 = makeManualTask(producer(0));
+    auto p2 = makeManualTask(producer(1));
+    p1.start();
+    p2.start();
+    TEST_ASSERT_FALSE(p1.done());
+    TEST_ASSERT_FALSE(p2.done());
+
+    e1.fireOnce();
+    TEST_ASSERT_TRUE(p1.done());
+    TEST_ASSERT_FALSE(p2.done());
+
+    e2.fireOnce();
+    TEST_ASSERT_TRUE(p2.done());
+
+    e2.fireOnce();
+    TEST_ASSERT_EQUAL(0, scope.size());
+}
+
+TEST_F(t_coro, add_when_ready_cancelled) {
+    DynamicScope scope(1);
+    CancellationSignal sig;
+    Event e;
+    bool started = false;
+
+    auto task = [&]() -> Async<> {
+        started = true;
+        co_return;
+    };
+
+    auto producer = [&]() -> Async<> {
+        auto ec = co_await scope.addWhenReady(task()).setCancellationSlot(sig.slot());
+        TEST_ASSERT_EQUAL(ErrCode::Cancelled, ec);
+    };
+
+    scope.add(e.wait());
+
+    auto m = makeManualTask(producer());
+    m.start();
+    TEST_ASSERT_FALSE(m.done());
+    TEST_ASSERT_TRUE(sig.hasHandler());
+
+    sig.emitSync();
+    TEST_ASSERT_TRUE(m.done());
+
+    e.fireOnce();
+    TEST_ASSERT_FALSE(started);
+    TEST_ASSERT_EQUAL(0, scope.size());
+}
+
+TEST_F(t_coro, join_with_parked_producer) {
+    DynamicScope scope(1);
+    Event e1, e2;
+
+    auto producer = [&]() -> Async<> {
+        TEST_ASSERT_EQUAL(ErrCode::Success, co_await scope.addWhenReady(e2.wait()));
+    };
+
+    auto joiner = [&]() -> Async<> { co_await scope.join(); };
+
+    scope.add(e1.wait());
+
+    auto p = makeManualTask(producer());
+    auto j = makeManualTask(joiner());
+    p.start();
+    j.start();
+
+    // the slot is handed over to the producer, join() keeps waiting
+    e1.fireOnce();
+    TEST_ASSERT_TRUE(p.done());
+    TEST_ASSERT_FALSE(j.done());
+    TEST_ASSERT_EQUAL(1, scope.size());
+
+    e2.fireOnce();
+    TEST_ASSERT_TRUE(j.done());
+}
+
 }  // namespace exec
 
 TESTS_MAIN
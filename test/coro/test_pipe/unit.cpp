@@ -0,0 +1,130 @@
+#include <exec/coro/Async.h>
+#include <exec/coro/ManualTask.h>
+#include <exec/coro/Task.h>
+#include <exec/coro/pipe.h>
+#include <exec/coro/sync/Event.h>
+#include <exec/result/syntax.h>
+
+#include "coro/test.h"
+
+#include <utest/utest.h>
+
+namespace exec {
+
+Async<int> twiceWhenSet(Event* event, int v) {
+    co_await event->wait();
+    co_return v * 2;
+}
+
+// Task ignores cancellation and completes with a value
+Task<int> onceSet(Event* event, int v) {
+    co_await event->wait();
+    co_return v;
+}
+
+Async<int> failing(int /*v*/) {
+    co_return err<int>(ErrCode::Exhausted);
+}
+
+Async<int> run(Event* event, Result<int> input, int* calls) {
+    co_return co_await (std::move(input) | (map([](int v) { return v + 1; }) |
+                                            asyncAndThen([event, calls](int v) {
+                                                ++*calls;
+                                                return twiceWhenSet(event, v);
+                                            }) |
+                                            map([](int v) { return v * 10; })));
+}
+
+Async<int> runUncancellable(Event* event, int* calls, int* mapped) {
+    co_return co_await (Result<int>{1} | (asyncAndThen([event](int v) {
+        return onceSet(event, v);
+    }) | map([mapped](int v) {
+        ++*mapped;
+        return v;
+    }) | asyncAndThen([event, calls](int v) {
+        ++*calls;
+        return twiceWhenSet(event, v);
+    })));
+}
+
+TEST_F(t_coro, async_pipeline) {
+    Event event;
+    int calls = 0;
+
+    auto task = makeManualTask(run(&event, 1, &calls));
+    task.start();
+    TEST_ASSERT_FALSE(task.done());
+
+    // run(), the pipeline and twiceWhenSet()
+    TEST_ASSERT_EQUAL(3, alloc::allocatedCount());
+
+    event.set();
+    TEST_ASSERT_TRUE(task.done());
+    TEST_ASSERT_EQUAL(1, calls);
+    TEST_ASSERT_EQUAL(40, *task.result());
+}
+
+TEST_F(t_coro, async_pipeline_error_skips_stages) {
+    Event event;
+    int calls = 0;
+
+    auto task = makeManualTask(run(&event, err<int>(ErrCode::Abandoned), &calls));
+    task.start();
+
+    TEST_ASSERT_TRUE(task.done());
+    TEST_ASSERT_EQUAL(0, calls);
+    TEST_ASSERT_EQUAL(ErrCode::Abandoned, task.result().code());
+}
+
+TEST_F(t_coro, async_stage_error) {
+    auto body = [](Result<int> input) -> Async<int> {
+        co_return co_await (std::move(input) | (asyncAndThen(failing) | orElse([](ErrCode) {
+            return Result<int>{5};
+        })));
+    };
+
+    auto task = makeManualTask(body(1));
+    task.start();
+
+    TEST_ASSERT_TRUE(task.done());
+    TEST_ASSERT_EQUAL(5, *task.result());
+}
+
+TEST_F(t_coro, async_pipeline_cancel) {
+    Event event;
+    int calls = 0;
+
+    CancellationSignal sig;
+    auto task = makeManualTask(run(&event, 1, &calls).setCancellationSlot(sig.slot()));
+    task.start();
+
+    sig.emitSync();
+    TEST_ASSERT_TRUE(task.done());
+    TEST_ASSERT_EQUAL(1, calls);
+    TEST_ASSERT_EQUAL(ErrCode::Cancelled, task.result().code());
+}
+
+TEST_F(t_coro, async_pipeline_cancel_skips_stages) {
+    Event event;
+    int calls = 0;
+    int mapped = 0;
+
+    CancellationSignal sig;
+    auto task =
+        makeManualTask(runUncancellable(&event, &calls, &mapped).setCancellationSlot(sig.slot()));
+    task.start();
+
+    sig.emitSync();
+    TEST_ASSERT_FALSE(task.done());
+
+    // the first stage completes with a value, the stages after it are never called
+    event.set();
+    TEST_ASSERT_TRUE(task.done());
+    TEST_ASSERT_EQUAL(0, mapped);
+    TEST_ASSERT_EQUAL(0, calls);
+    TEST_ASSERT_EQUAL(ErrCode::Cancelled, task.result().code());
+}
+
+}  // namespace exec
+
+TESTS_MAIN
@@ -0,0 +1,165 @@
+#include "Executor.h"
+#include "coro/test.h"
+
+#include <exec/coro/Async.h>
+#include <exec/coro/ManualTask.h>
+#include <exec/coro/schedule.h>
+#include <exec/coro/spawn.h>
+#include <exec/coro/sync/Event.h>
+
+#include <utest/utest.h>
+
+namespace exec {
+
+struct t_schedule : t_coro {
+    t_schedule() { setService<Executor>(&executor); }
+
+    test::Executor executor;
+    test::Executor other;
+};
+
+static_assert(CancellableAwaitable<decltype(resumeOn(nullptr, std::declval<Async<int>>()))>);
+
+TEST_F(t_schedule, schedule_on) {
+    auto body = [&]() -> Async<> {  //
+        co_await scheduleOn(&other);
+    };
+
+    auto coro = makeManualTask(body());
+
+    coro.start();
+    TEST_ASSERT_FALSE(coro.done());
+    TEST_ASSERT_EQUAL(0, executor.queued.size());
+    TEST_ASSERT_EQUAL(1, other.queued.size());
+
+    other.queued.popFront()->run();
+    TEST_ASSERT_TRUE(coro.done());
+}
+
+TEST_F(t_schedule, schedule_on_cancelled) {
+    CancellationSignal sig;
+
+    auto body = [&]() -> Async<> {  //
+        co_await scheduleOn(&other).setCancellationSlot(sig.slot());
+    };
+    auto coro = makeManualTask(body());
+
+    coro.start();
+    TEST_ASSERT_EQUAL(1, other.queued.size());
+
+    // taken back from the queue, resumed inline
+    sig.emitSync();
+    TEST_ASSERT_TRUE(coro.done());
+    TEST_ASSERT_EQUAL(0, other.queued.size());
+}
+
+TEST_F(t_schedule, resume_on) {
+    Event e;
+
+    auto task = [&]() -> Async<int> {
+        (void)co_await e.wait();
+        co_return 10;
+    };
+
+    auto body = [&]() -> Async<> {
+        auto res = co_await resumeOn(&other, task());
+        TEST_ASSERT_TRUE(res);
+        TEST_ASSERT_EQUAL(10, *res);
+    };
+
+    auto coro = makeManualTask(body());
+
+    coro.start();
+    TEST_ASSERT_FALSE(coro.done());
+
+    e.fireOnce();
+    TEST_ASSERT_FALSE(coro.done());  // not resumed inline
+    TEST_ASSERT_EQUAL(1, other.queued.size());
+
+    other.queued.popFront()->run();
+    TEST_ASSERT_TRUE(coro.done());
+}
+
+TEST_F(t_schedule, resume_on_ready) {
+    auto task = []() -> Async<int> { co_return 20; };
+
+    auto body = [&]() -> Async<> {
+        auto res = co_await resumeOn(&other, task());
+        TEST_ASSERT_EQUAL(20, *res);
+    };
+
+    auto coro = makeManualTask(body());
+
+    coro.start();
+    TEST_ASSERT_FALSE(coro.done());
+
+    other.queued.popFront()->run();
+    TEST_ASSERT_TRUE(coro.done());
+}
+
+TEST_F(t_schedule, resume_on_status) {
+    struct FailingStatus {
+        struct Awaiter {
+            bool await_ready() const { return true; }
+            void await_suspend(std::coroutine_handle<>) const {}
+            Status await_resume() const { return err<Unit>(ErrCode::Exhausted); }
+        };
+
+        Awaiter operator co_await() const { return {}; }
+    };
+
+    static_assert(std::same_as<decltype(resumeOn(nullptr, FailingStatus{})), Async<>>);
+
+    auto body = [&]() -> Async<> {
+        auto res = co_await resumeOn(&other, FailingStatus{});
+        TEST_ASSERT_FALSE(res);
+        TEST_ASSERT_EQUAL(ErrCode::Exhausted, res.code());
+    };
+
+    auto coro = makeManualTask(body());
+
+    coro.start();
+    TEST_ASSERT_FALSE(coro.done());
+
+    other.queued.popFront()->run();
+    TEST_ASSERT_TRUE(coro.done());
+}
+
+TEST_F(t_schedule, resume_on_cancelled) {
+    CancellationSignal sig;
+    Event e;
+
+    auto body = [&]() -> Async<> {
+        auto res = co_await resumeOn(&other, e.wait()).setCancellationSlot(sig.slot());
+        TEST_ASSERT_EQUAL(ErrCode::Cancelled, res.code());
+    };
+
+    auto coro = makeManualTask(body());
+
+    coro.start();
+    TEST_ASSERT_FALSE(coro.done());
+
+    sig.emitSync();
+    TEST_ASSERT_TRUE(coro.done());
+    TEST_ASSERT_EQUAL(0, other.queued.size());
+}
+
+TEST_F(t_schedule, spawn_on) {
+    bool done = false;
+
+    auto task = [&]() -> Async<> {
+        done = true;
+        co_return;
+    };
+
+    spawn(&other, task());
+    TEST_ASSERT_EQUAL(0, executor.queued.size());
+    TEST_ASSERT_EQUAL(1, other.queued.size());
+
+    other.queued.popFront()->run();
+    TEST_ASSERT_TRUE(done);
+}
+
+}  // namespace exec
+
+TESTS_MAIN
@@ -2,6 +2,7 @@
 #include "coro/test.h"
 
 #include <exec/coro/Async.h>
+#include <exec/coro/ManualTask.h>
 #include <exec/coro/spawn.h>
 #include <exec/coro/sync/Event.h>
 
@@ -33,6 +34,154 @@ TEST_F(t_spawn, simple_spawn) {
     TEST_ASSERT_TRUE(done);
 }
 
+static_assert(CancellableAwaitable<JoinHandle<Result<int>>>);
+
+TEST_F(t_spawn, join_completed) {
+    auto task = [&]() -> Async<int> { co_return 10; };
+
+    auto handle = spawnWithHandle(task());
+    executor.queued.popFront()->run();
+    TEST_ASSERT_TRUE(handle.done());
+
+    auto m = makeManualTask(std::move(handle));
+    m.start();
+    TEST_ASSERT_TRUE(m.done());
+    TEST_ASSERT_EQUAL(10, *m.result());
+}
+
+TEST_F(t_spawn, join_pending) {
+    Event event;
+
+    auto task = [&]() -> Async<int> {
+        (void)co_await event.wait();
+        co_return 20;
+    };
+
+    auto m = makeManualTask(spawnWithHandle(task()));
+    m.start();
+    TEST_ASSERT_FALSE(m.done());
+
+    executor.queued.popFront()->run();
+    TEST_ASSERT_FALSE(m.done());
+
+    event.fireOnce();
+    TEST_ASSERT_TRUE(m.done());
+    TEST_ASSERT_EQUAL(20, *m.result());
+}
+
+TEST_F(t_spawn, drop_handle_detaches) {
+    bool done = false;
+    Event event;
+
+    auto task = [&]() -> Async<> {
+        (void)co_await event.wait();
+        done = true;
+    };
+
+    SECTION("before completion") {
+        {
+            auto handle = spawnWithHandle(task());
+        }
+
+        executor.queued.popFront()->run();
+        event.fireOnce();
+        TEST_ASSERT_TRUE(done);
+    }
+
+    SECTION("after completion") {
+        auto handle = spawnWithHandle(task());
+        executor.queued.popFront()->run();
+        event.fireOnce();
+        TEST_ASSERT_TRUE(handle.done());
+        TEST_ASSERT_TRUE(done);
+    }
+}
+
+TEST_F(t_spawn, cancel_join) {
+    CancellationSignal sig;
+    Event event;
+
+    auto task = [&]() -> Async<int> {
+        auto ec = co_await event.wait();
+        TEST_ASSERT_EQUAL(ErrCode::Cancelled, ec);
+        co_return 30;
+    };
+
+    auto handle = spawnWithHandle(task());
+    executor.queued.popFront()->run();
+
+    auto m = makeManualTask(std::move(handle.setCancellationSlot(sig.slot())));
+    m.start();
+    TEST_ASSERT_FALSE(m.done());
+    TEST_ASSERT_TRUE(sig.hasHandler());
+
+    sig.emitSync();
+    TEST_ASSERT_TRUE(m.done());
+    TEST_ASSERT_FALSE(sig.hasHandler());
+    TEST_ASSERT_EQUAL(30, *m.result());
+}
+
+TEST_F(t_spawn, request_cancel) {
+    Event event;
+
+    auto task = [&]() -> Async<int> {
+        (void)co_await event.wait();
+        co_return 40;
+    };
+
+    auto handle = spawnWithHandle(task());
+    executor.queued.popFront()->run();
+    TEST_ASSERT_FALSE(handle.done());
+
+    handle.requestCancel();
+    TEST_ASSERT_TRUE(handle.done());
+}
+
+TEST_F(t_spawn, request_cancel_before_start) {
+    Event event;
+    bool resumed = false;
+
+    auto task = [&]() -> Async<int> {
+        (void)co_await event.wait();
+        resumed = true;
+        co_return 50;
+    };
+
+    auto handle = spawnWithHandle(task());
+    handle.requestCancel();
+    TEST_ASSERT_FALSE(handle.done());
+
+    executor.queued.popFront()->run();
+    TEST_ASSERT_TRUE(handle.done());
+    TEST_ASSERT_FALSE(resumed);
+
+    auto m = makeManualTask(std::move(handle));
+    m.start();
+    TEST_ASSERT_TRUE(m.done());
+    TEST_ASSERT_EQUAL(ErrCode::Cancelled, m.result().code());
+}
+
+TEST_F(t_spawn, cancel_join_before_start) {
+    CancellationSignal sig;
+    Event event;
+
+    auto task = [&]() -> Async<int> {
+        (void)co_await event.wait();
+        co_return 60;
+    };
+
+    auto handle = spawnWithHandle(task());
+    auto m = makeManualTask(std::move(handle.setCancellationSlot(sig.slot())));
+    m.start();
+    sig.emitSync();
+    TEST_ASSERT_FALSE(m.done());
+
+    // the join waits for the task, which sees the cancellation once started
+    executor.queued.popFront()->run();
+    TEST_ASSERT_TRUE(m.done());
+    TEST_ASSERT_EQUAL(ErrCode::Cancelled, m.result().code());
+}
+
 }  // namespace exec
 
 TESTS_MAIN
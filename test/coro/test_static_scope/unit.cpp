@@ -0,0 +1,213 @@
+#include "coro/test.h"
+
+#include <exec/coro/Async.h>
+#include <exec/coro/ManualTask.h>
+#include <exec/coro/StaticScope.h>
+#include <exec/coro/sync/Event.h>
+
+#include <utest/utest.h>
+
+namespace exec {
+
+using Scope = StaticScope<3, 256>;
+
+TEST_F(t_coro, join_empty) {
+    auto coro = [&]() -> Async<> {
+        Scope scope;
+        co_await scope.join();
+    };
+
+    auto m = makeManualTask(coro());
+
+    m.start();
+    TEST_ASSERT_TRUE(m.done());
+}
+
+TEST_F(t_coro, join_sync) {
+    Event e;
+
+    auto coro = [&]() -> Async<> {
+        Scope scope;
+
+        TEST_ASSERT_TRUE(scope.add(e.wait()));
+        TEST_ASSERT_TRUE(scope.add(e.wait()));
+        TEST_ASSERT_TRUE(scope.add(e.wait()));
+
+        co_await scope.join();
+    };
+
+    auto m = makeManualTask(coro());
+
+    e.set();
+    m.start();
+    TEST_ASSERT_TRUE(m.done());
+}
+
+TEST_F(t_coro, join_tasks) {
+    Scope scope;
+    Event e;
+
+    TEST_ASSERT_TRUE(scope.add(e.wait()));
+    TEST_ASSERT_TRUE(scope.add(e.wait()));
+
+    auto m = makeManualTask(scope.join());
+
+    m.start();
+    TEST_ASSERT_FALSE(m.done());
+    TEST_ASSERT_EQUAL(2, scope.size());
+
+    e.fireOnce();
+    TEST_ASSERT_TRUE(m.done());
+    TEST_ASSERT_EQUAL(0, scope.size());
+}
+
+Async<> waitFor(Event& e) {
+    (void)co_await e.wait();
+}
+
+TEST_F(t_coro, join_async_tasks) {
+    Scope scope;
+    Event e;
+
+    TEST_ASSERT_TRUE(scope.add(waitFor(e)));
+    TEST_ASSERT_TRUE(scope.add(waitFor(e)));
+
+    // only the frames of the Async<> children, the scope's frames are placed into slots
+    TEST_ASSERT_EQUAL(2, alloc::allocatedCount());
+
+    auto m = makeManualTask(scope.join());
+    m.start();
+    TEST_ASSERT_FALSE(m.done());
+
+    e.fireOnce();
+    TEST_ASSERT_TRUE(m.done());
+    TEST_ASSERT_EQUAL(0, alloc::allocatedCount());
+}
+
+TEST_F(t_coro, add_when_full) {
+    Scope scope;
+    Event e;
+
+    TEST_ASSERT_TRUE(scope.add(e.wait()));
+    TEST_ASSERT_TRUE(scope.add(e.wait()));
+    TEST_ASSERT_TRUE(scope.add(e.wait()));
+    TEST_ASSERT_FALSE(scope.add(e.wait()));
+    TEST_ASSERT_EQUAL(3, scope.size());
+
+    e.fireOnce();
+    TEST_ASSERT_EQUAL(0, scope.size());
+
+    // slots are reused
+    TEST_ASSERT_TRUE(scope.add(e.wait()));
+    TEST_ASSERT_EQUAL(1, scope.size());
+    e.fireOnce();
+}
+
+TEST_F(t_coro, add_frame_too_large) {
+    StaticScope<1, 8> scope;
+    Event e;
+
+    TEST_ASSERT_FALSE(scope.add(e.wait()));
+    TEST_ASSERT_EQUAL(0, scope.size());
+}
+
+TEST_F(t_coro, failed_add_keeps_awaitable) {
+    StaticScope<1, 256> scope;
+    Event e;
+
+    TEST_ASSERT_TRUE(scope.add(waitFor(e)));
+
+    auto task = waitFor(e);
+    TEST_ASSERT_FALSE(scope.add(std::move(task)));
+
+    // not started, still owned by the caller
+    auto m = makeManualTask(std::move(task));
+    m.start();
+    TEST_ASSERT_FALSE(m.done());
+
+    e.fireOnce();
+    TEST_ASSERT_TRUE(m.done());
+    TEST_ASSERT_EQUAL(0, scope.size());
+}
+
+TEST_F(t_coro, cancel_join) {
+    CancellationSignal sig;
+    Event e;
+
+    auto coro = [&]() -> Async<> {
+        Scope scope;
+
+        TEST_ASSERT_TRUE(scope.add(e.wait()));
+        TEST_ASSERT_TRUE(scope.add(e.wait()));
+        TEST_ASSERT_TRUE(scope.add(e.wait()));
+
+        co_await scope.join().setCancellationSlot(sig.slot());
+    };
+
+    auto m = makeManualTask(coro());
+
+    m.start();
+    TEST_ASSERT_FALSE(m.done());
+
+    sig.emitSync();
+    TEST_ASSERT_TRUE(m.done());
+    TEST_ASSERT_FALSE(sig.hasHandler());
+}
+
+TEST_F(t_coro, cancel_partial_complete) {
+    CancellationSignal sig;
+    Event e1, e2;
+
+    auto coro = [&]() -> Async<> {
+        Scope scope;
+
+        TEST_ASSERT_TRUE(scope.add(e1.wait()));
+        TEST_ASSERT_TRUE(scope.add(e2.wait()));
+
+        co_await scope.join().setCancellationSlot(sig.slot());
+    };
+
+    auto m = makeManualTask(coro());
+
+    m.start();
+    TEST_ASSERT_FALSE(m.done());
+
+    SECTION("complete first") {
+        e1.fireOnce();
+    }
+
+    SECTION("complete second") {
+        e2.fireOnce();
+    }
+
+    TEST_ASSERT_FALSE(m.done());
+    sig.emitSync();
+    TEST_ASSERT_TRUE(m.done());
+    TEST_ASSERT_FALSE(sig.hasHandler());
+}
+
+TEST_F(t_coro, drop_join) {
+    CancellationSignal sig;
+    Event e1, e2;
+
+    auto coro = [&]() -> Async<> {
+        (void)co_await e1.wait();
+
+        Scope scope;
+        TEST_ASSERT_TRUE(scope.add(e2.wait()));
+        co_await scope.join();
+    };
+
+    auto m = makeManualTask(coro().setCancellationSlot(sig.slot()));
+
+    e2.set();
+    m.start();
+    TEST_ASSERT_FALSE(m.done());
+
+    sig.emitSync();
+    TEST_ASSERT_TRUE(m.done());
+}
+
+}  // namespace exec
+
+TESTS_MAIN
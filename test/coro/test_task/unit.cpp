@@ -0,0 +1,122 @@
+#include "coro/test.h"
+
+#include <exec/coro/Async.h>
+#include <exec/coro/ManualTask.h>
+#include <exec/coro/Task.h>
+#include <exec/coro/sync/Event.h>
+
+#include <utest/utest.h>
+
+namespace exec {
+
+static_assert(Awaitable<Task<>>);
+static_assert(!CancellableAwaitable<Task<>>);
+static_assert(std::same_as<typename Task<>::value_type, Result<Unit>>);
+static_assert(std::same_as<typename Task<int&>::value_type, Result<int&>>);
+
+TEST_F(t_coro, initial_suspend) {
+    bool done = false;
+
+    auto coro = [&]() -> Task<> {
+        done = true;
+        co_return;
+    };
+
+    auto m = makeManualTask(coro());
+
+    TEST_ASSERT_FALSE(m.done());
+    TEST_ASSERT_FALSE(done);
+
+    m.start();
+
+    TEST_ASSERT_TRUE(m.done());
+    TEST_ASSERT_TRUE(done);
+}
+
+TEST_F(t_coro, co_return_value) {
+    auto task = []() -> Task<int> {  //
+        co_return 239;
+    };
+
+    auto failing = []() -> Task<int> {  //
+        co_return err<int>(ErrCode::Exhausted);
+    };
+
+    auto main = [&]() -> Task<int> {
+        auto x = co_await task();
+        TEST_ASSERT_EQUAL(239, *x);
+
+        auto y = co_await failing();
+        TEST_ASSERT_EQUAL(ErrCode::Exhausted, y.code());
+
+        co_return *x + 1;
+    };
+
+    auto m = makeManualTask(main());
+
+    m.start();
+    TEST_ASSERT_TRUE(m.done());
+    TEST_ASSERT_EQUAL(240, *m.result());
+}
+
+TEST_F(t_coro, mixed_with_async) {
+    Event e;
+
+    auto leaf = [&]() -> Async<int> {
+        (void)co_await e.wait();
+        co_return 10;
+    };
+
+    auto middle = [&]() -> Task<int> {
+        auto x = co_await leaf();
+        co_return *x * 2;
+    };
+
+    auto main = [&]() -> Async<int> {
+        auto x = co_await middle();
+        co_return *x + 1;
+    };
+
+    auto m = makeManualTask(main());
+
+    m.start();
+    TEST_ASSERT_FALSE(m.done());
+
+    e.set();
+    TEST_ASSERT_TRUE(m.done());
+    TEST_ASSERT_EQUAL(21, *m.result());
+}
+
+// A Task is not cancellable, the cancelled parent waits for it to complete
+TEST_F(t_coro, runs_to_completion) {
+    Event e;
+    CancellationSignal sig;
+    bool completed = false;
+
+    auto child = [&]() -> Task<> {
+        auto ec = co_await e.wait();
+        TEST_ASSERT_EQUAL(ErrCode::Success, ec);
+        completed = true;
+    };
+
+    auto parent = [&]() -> Async<> {
+        (void)co_await child();
+        (void)co_await child();  // finalizes here
+        TEST_FAIL_MESSAGE("should've not reached this point");
+    };
+
+    auto m = makeManualTask(parent().setCancellationSlot(sig.slot()));
+
+    m.start();
+    sig.emitSync();
+    TEST_ASSERT_FALSE(m.done());
+
+    e.fireOnce();
+    TEST_ASSERT_TRUE(completed);
+    TEST_ASSERT_TRUE(m.done());
+    TEST_ASSERT_EQUAL(ErrCode::Cancelled, m.result().code());
+}
+
+}  // namespace exec
+
+TESTS_MAIN
@@ -0,0 +1,123 @@
+#include <exec/coro/Async.h>
+#include <exec/coro/ManualTask.h>
+#include <exec/coro/Task.h>
+
+#include <utest/utest.h>
+
+// Define EXEC_BENCH_PRINT to print the measurements
+#if !defined(ARDUINO)
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#endif
+
+#if !defined(ARDUINO)
+
+namespace exec::alloc {
+
+size_t last_size = 0;
+
+void* allocate(size_t size, const std::nothrow_t&) noexcept {
+    last_size = size;
+    return malloc(size);
+}
+
+void deallocate(void* ptr, size_t) noexcept {
+    free(ptr);
+}
+
+}  // namespace exec::alloc
+
+#endif
+
+namespace exec {
+
+#if !defined(ARDUINO)
+
+namespace {
+
+// Without optimizations symmetric transfer is not a tail call and every co_await of a
+// completed leaf nests on the stack, so the loops are kept short
+constexpr int Iterations = 64;
+constexpr int Batches = 4000;
+
+Async<int> asyncLeaf(int x) {
+    co_return x + 1;
+}
+
+Task<int> taskLeaf(int x) {
+    co_return x + 1;
+}
+
+Async<int> eagerLoop() {
+    int x = 0;
+    for (int i = 0; i < Iterations; ++i) {
+        x = *co_await asyncLeaf(x).eager();
+    }
+    co_return x;
+}
+
+template <template <typename> typename Coro, typename Leaf>
+Coro<int> loop(Leaf leaf) {
+    int x = 0;
+    for (int i = 0; i < Iterations; ++i) {
+        x = *co_await leaf(x);
+    }
+    co_return x;
+}
+
+// Returns nanoseconds per co_await of a leaf
+template <typename F>
+double run(F makeLoop) {
+    const auto start = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < Batches; ++i) {
+        auto task = makeManualTask(makeLoop());
+        task.start();
+        TEST_ASSERT_TRUE(task.done());
+        TEST_ASSERT_EQUAL(Iterations, *task.result());
+    }
+
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / (Batches * Iterations);
+}
+
+}  // namespace
+
+TEST(frame_size) {
+    (void)asyncLeaf(0);
+    const size_t async_size = alloc::last_size;
+
+    (void)taskLeaf(0);
+    const size_t task_size = alloc::last_size;
+
+#if defined(EXEC_BENCH_PRINT)
+    std::printf("leaf frame: Async %zu bytes, Task %zu bytes\n", async_size, task_size);
+#endif
+    TEST_ASSERT_TRUE(task_size < async_size);
+}
+
+TEST(await_latency) {
+    CancellationSignal sig;
+
+    // children of a cancellable Async get a cancellation slot each
+    const double async_ns =
+        run([&sig] { return loop<Async>(asyncLeaf).setCancellationSlot(sig.slot()); });
+    const double eager_ns = run([&sig] { return eagerLoop().setCancellationSlot(sig.slot()); });
+    const double task_ns = run([] { return loop<Task>(taskLeaf); });
+
+#if defined(EXEC_BENCH_PRINT)
+    std::printf("co_await leaf: Async %.1f ns, eager Async %.1f ns, Task %.1f ns\n", async_ns,
+        eager_ns, task_ns);
+#else
+    (void)async_ns;
+    (void)eager_ns;
+    (void)task_ns;
+#endif
+}
+
+#endif
+
+}  // namespace exec
+
+TESTS_MAIN
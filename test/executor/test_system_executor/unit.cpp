@@ -2,6 +2,9 @@
 
 #include <utest/utest.h>
 
+#include <string>
+#include <vector>
+
 namespace exec {
 
 TEST(test_run_empty) {
@@ -64,6 +67,50 @@ TEST(test_run_order_push_during_tick) {
     TEST_ASSERT_EQUAL(6, counter);
 }
 
+TEST(test_remove) {
+    SystemExecutor exec;
+    int counter = 0;
+
+    auto task = [&counter]() { return runnable([&counter](auto) { ++counter; }); };
+
+    auto t0 = task();
+    auto t1 = task();
+    auto t2 = task();
+
+    exec.post(&t0);
+    exec.post(&t1);
+    exec.post(&t2);
+
+    TEST_ASSERT_TRUE(exec.remove(&t1));
+    TEST_ASSERT_FALSE(exec.remove(&t1));
+
+    exec.tick();
+    TEST_ASSERT_EQUAL(2, counter);
+    TEST_ASSERT_FALSE(exec.remove(&t2));  // already run
+    TEST_ASSERT_EQUAL(ttime::Time::max().millis(), exec.wakeAt().millis());
+}
+
+TEST(test_remove_during_tick) {
+    SystemExecutor exec;
+    int counter = 0;
+
+    auto t1 = runnable([&counter](auto) { ++counter; });
+    auto t2 = runnable([&counter](auto) { ++counter; });
+    auto t0 = runnable([&](auto) {
+        // taken for this tick already, not run yet
+        TEST_ASSERT_TRUE(exec.remove(&t1));
+        ++counter;
+    });
+
+    exec.post(&t0);
+    exec.post(&t1);
+    exec.post(&t2);
+
+    exec.tick();
+    TEST_ASSERT_EQUAL(2, counter);
+    TEST_ASSERT_EQUAL(ttime::Time::max().millis(), exec.wakeAt().millis());
+}
+
 TEST(test_wake_at) {
     SystemExecutor exec;
 
@@ -78,6 +125,78 @@ TEST(test_wake_at) {
     }
 }
 
+#if EXEC_PROFILE
+
+TEST(test_stats) {
+    ttime::mono::set(ttime::Time(0));
+    SystemExecutor exec;
+
+    // takes 3ms to run
+    auto busy = runnable([](auto) { ttime::mono::advance(ttime::Duration(3)); });
+    auto quick = runnable([](auto) {});
+
+    exec.post(&busy);
+    exec.post(&quick);
+    TEST_ASSERT_EQUAL(2, exec.stats().depth);
+
+    ttime::mono::advance(ttime::Duration(2));
+    exec.tick();
+
+    const auto& s = exec.stats();
+    TEST_ASSERT_EQUAL(2, s.runs);
+    TEST_ASSERT_EQUAL(0, s.depth);
+    TEST_ASSERT_EQUAL(2, s.maxDepth);
+    TEST_ASSERT_EQUAL(2, s.lastDrained);
+
+    // busy waited 2ms, quick 5ms: buckets [1024, 2048) and [4096, 8192)
+    TEST_ASSERT_EQUAL(1, s.wait.counts[11]);
+    TEST_ASSERT_EQUAL(1, s.wait.counts[13]);
+    // runs took 3ms and 0ms
+    TEST_ASSERT_EQUAL(1, s.run.counts[12]);
+    TEST_ASSERT_EQUAL(1, s.run.counts[0]);
+
+    SECTION("drained per tick") {
+        exec.post(&quick);
+        exec.tick();
+        TEST_ASSERT_EQUAL(1, exec.stats().lastDrained);
+        TEST_ASSERT_EQUAL(2, exec.stats().maxDrained);
+    }
+
+    SECTION("reset keeps the depth") {
+        exec.post(&quick);
+        exec.resetStats();
+        TEST_ASSERT_EQUAL(1, exec.stats().depth);
+        TEST_ASSERT_EQUAL(0, exec.stats().runs);
+        exec.tick();
+        TEST_ASSERT_EQUAL(0, exec.stats().depth);
+    }
+
+    SECTION("print") {
+        std::vector<std::string> lines;
+        exec.stats().print([&lines](const char* l) { lines.emplace_back(l); });
+
+        TEST_ASSERT_EQUAL(3, lines.size());
+        TEST_ASSERT_EQUAL(0, lines[0].find("runs=2 depth=0 max=2"));
+        TEST_ASSERT_TRUE(lines[1] == "wait <2048us:1 <8192us:1");
+        TEST_ASSERT_TRUE(lines[2] == "run <1us:1 <4096us:1");
+    }
+}
+
+TEST(test_histogram_bounds) {
+    Log2Histogram h;
+    h.add(0);
+    h.add(1);
+    h.add(3);
+    h.add(UINT32_MAX);
+
+    TEST_ASSERT_EQUAL(1, h.counts[0]);
+    TEST_ASSERT_EQUAL(1, h.counts[1]);
+    TEST_ASSERT_EQUAL(1, h.counts[2]);
+    TEST_ASSERT_EQUAL(1, h.counts[Log2Histogram::Buckets - 1]);
+}
+
+#endif
+
 }  // namespace exec
 
 TESTS_MAIN
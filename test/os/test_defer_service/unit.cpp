@@ -10,8 +10,14 @@ void setUp() {
 
 namespace exec {
 
-auto makeTask(int& cnt) {
-    return runnable([&cnt](auto) { ++cnt; });
+struct Task : DeferEntry {
+    explicit Task(int& cnt) : cnt{cnt} {}
+    void run() override { ++cnt; }
+    int& cnt;
+};
+
+Task makeTask(int& cnt) {
+    return Task{cnt};
 }
 
 TEST(test_tick_empty) {
@@ -60,6 +66,47 @@ TEST(test_wake_at) {
     }
 }
 
+TEST(test_cancel) {
+    int cnt = 0;
+    auto first = makeTask(cnt);
+    auto second = makeTask(cnt);
+    HeapDeferService<2> ds;
+
+    TEST_ASSERT_TRUE(ds.defer(&first, ttime::Time(10)));
+    TEST_ASSERT_TRUE(ds.defer(&second, ttime::Time(20)));
+
+    TEST_ASSERT_TRUE(ds.cancel(&first));
+    TEST_ASSERT_FALSE(ds.cancel(&first));
+    TEST_ASSERT_EQUAL(1, ds.size());
+    TEST_ASSERT_EQUAL(ttime::Time(20).millis(), ds.wakeAt().millis());
+
+    ttime::mono::advance(ttime::Duration(25));
+    ds.tick();
+    TEST_ASSERT_EQUAL(1, cnt);
+    TEST_ASSERT_FALSE(ds.cancel(&second));  // already run
+}
+
+// Implements only the Runnable interface
+struct RunnableDeferService : DeferService {
+    bool defer(Runnable* r, ttime::Time /*at*/) override {
+        deferred = r;
+        return true;
+    }
+
+    Runnable* deferred = nullptr;
+};
+
+TEST(test_runnable_service) {
+    int cnt = 0;
+    auto task = makeTask(cnt);
+    RunnableDeferService rds;
+    DeferService& ds = rds;
+
+    TEST_ASSERT_TRUE(ds.defer(&task, ttime::Time(10)));
+    TEST_ASSERT_TRUE(rds.deferred == &task);
+    TEST_ASSERT_FALSE(ds.cancel(&task));  // runs as deferred
+}
+
 }  // namespace exec
 
 TESTS_MAIN
@@ -2,8 +2,11 @@
 #include <exec/os/OS.h>
 
 #include <time/config.h>
+#include <time/mono.h>
 #include <utest/utest.h>
 
+#include <cstring>
+
 namespace exec {
 
 struct MockService : Service {
@@ -19,6 +22,16 @@ struct MockService : Service {
     ttime::Time wake_at = ttime::Time::max();
 };
 
+// Takes `busy` of manual time to tick
+struct BusyService : MockService {
+    void tick() override {
+        MockService::tick();
+        ttime::mono::advance(busy);
+    }
+
+    ttime::Duration busy;
+};
+
 auto makeTask(int& cnt) {
     return runnable([&cnt](auto) { ++cnt; });
 }
@@ -61,6 +74,70 @@ TEST(test_wake_at) {
     }
 }
 
+#if EXEC_PROFILE
+
+TEST(test_stats) {
+    ttime::mono::set(ttime::Time(0));
+    OS os;
+    BusyService a;
+    BusyService b;
+    os.addService(&a);
+    os.addService(&b);
+
+    a.busy = ttime::Duration(2);
+    b.wake_at = ttime::Time(1);
+    os.tick();  // a: 0..2, b: 2..2, late by 1ms
+
+    a.busy = ttime::Duration(5);
+    b.wake_at = ttime::Time(100);
+    os.tick();  // a: 2..7, b is not due
+
+    SECTION("durations") {
+        const auto& s = a.stats();
+        TEST_ASSERT_EQUAL(2, s.ticks);
+        TEST_ASSERT_EQUAL(7000, s.totalUs);
+        TEST_ASSERT_EQUAL(5000, s.maxUs);
+        TEST_ASSERT_EQUAL(5000, s.lastUs);
+        TEST_ASSERT_EQUAL(3500, s.avgUs());
+        TEST_ASSERT_EQUAL(0, s.dueTicks);
+    }
+
+    SECTION("lateness") {
+        const auto& s = b.stats();
+        TEST_ASSERT_EQUAL(2, s.ticks);
+        TEST_ASSERT_EQUAL(0, s.maxUs);
+        TEST_ASSERT_EQUAL(1, s.dueTicks);
+        TEST_ASSERT_EQUAL(1000, s.maxLateUs);
+        TEST_ASSERT_EQUAL(1000, s.lastLateUs);
+    }
+
+    SECTION("reset") {
+        os.resetStats();
+        TEST_ASSERT_EQUAL(0, a.stats().ticks);
+        TEST_ASSERT_EQUAL(0, b.stats().dueTicks);
+    }
+
+    SECTION("print") {
+        int lines = 0;
+        os.printStats([&lines](const char* line) {
+            if (lines++ == 0) {
+                TEST_ASSERT_EQUAL(0, std::strncmp(line, "service #0: ticks=2 total=7ms", 29));
+            }
+        });
+        TEST_ASSERT_EQUAL(2, lines);
+    }
+
+    SECTION("iterate") {
+        int services = 0;
+        os.forEachService([&](const Service& s) {
+            TEST_ASSERT_TRUE(&s == (services++ == 0 ? &a : &b));
+        });
+        TEST_ASSERT_EQUAL(2, services);
+    }
+}
+
+#endif
+
 }  // namespace exec
 
 TESTS_MAIN
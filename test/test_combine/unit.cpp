@@ -0,0 +1,110 @@
+#include <exec/result/combine.h>
+#include <exec/result/syntax.h>
+
+#include <utest/utest.h>
+
+#include <utility>
+
+namespace exec {
+
+struct Big {
+    explicit Big(int v) : value{v} {}
+    Big(Big&& r) noexcept : value{r.value} { ++moves; }
+    Big& operator=(Big&& r) noexcept {
+        value = r.value;
+        ++moves;
+        return *this;
+    }
+
+    int value;
+    char payload[64]{};
+
+    static inline int moves = 0;
+};
+
+auto half = [](int v) -> Result<int> {
+    if (v % 2 != 0) {
+        return err<int>(ErrCode::Exhausted);
+    }
+    return v / 2;
+};
+
+TEST(test_single_stages) {
+    SECTION("andThen") {
+        TEST_ASSERT_EQUAL(2, *(ok(4) | andThen(half)));
+        TEST_ASSERT_EQUAL(ErrCode::Exhausted, (ok(3) | andThen(half)).code());
+        TEST_ASSERT_EQUAL(ErrCode::Cancelled, (err<int>(ErrCode::Cancelled) | andThen(half)).code());
+    }
+
+    SECTION("map") {
+        TEST_ASSERT_EQUAL(5, *(ok(4) | map([](int v) { return v + 1; })));
+    }
+
+    SECTION("orElse") {
+        auto fallback = orElse([](ErrCode) -> Result<int> { return 7; });
+        TEST_ASSERT_EQUAL(7, *(err<int>(ErrCode::Cancelled) | std::move(fallback)));
+        TEST_ASSERT_EQUAL(1, *(ok(1) | orElse([](ErrCode) -> Result<int> { return 7; })));
+    }
+
+    SECTION("lvalue result is copied") {
+        const Result<int> r = 8;
+        TEST_ASSERT_EQUAL(4, *(r | andThen(half)));
+        TEST_ASSERT_EQUAL(8, *r);
+    }
+}
+
+TEST(test_fused_pipeline) {
+    auto pipeline = [] {
+        return andThen(half) | map([](int v) { return v * 10; }) |
+               orElse([](ErrCode code) -> Result<int> {
+                   return code == ErrCode::Exhausted ? Result<int>{-1} : err<int>(code);
+               }) |
+               andThen(half);
+    };
+
+    TEST_ASSERT_EQUAL(10, *(ok(4) | pipeline()));
+
+    // half() fails, orElse recovers in the middle of the pipeline, the last half() fails again
+    TEST_ASSERT_EQUAL(ErrCode::Exhausted, (ok(3) | pipeline()).code());
+
+    TEST_ASSERT_EQUAL(ErrCode::Cancelled, (err<int>(ErrCode::Cancelled) | pipeline()).code());
+
+    SECTION("errors skip stages") {
+        int calls = 0;
+        auto r = err<int>(ErrCode::Abandoned) | (map([&](int v) {
+            ++calls;
+            return v;
+        }) | andThen([&](int v) -> Result<int> {
+            ++calls;
+            return v;
+        }));
+
+        TEST_ASSERT_EQUAL(ErrCode::Abandoned, r.code());
+        TEST_ASSERT_EQUAL(0, calls);
+    }
+}
+
+TEST(test_fused_pipeline_keeps_values_in_place) {
+    auto make = [](int v) -> Result<Big> { return Big{v}; };
+    auto check = [](const Big& b) -> Result<int> { return b.value; };
+    auto get = [](int v) { return v + 1; };
+
+    Big::moves = 0;
+    auto chained = ok(1) | andThen(make) | andThen(check) | map(get);
+    const int chained_moves = Big::moves;
+
+    Big::moves = 0;
+    auto fused = ok(1) | (andThen(make) | andThen(check) | map(get));
+    const int fused_moves = Big::moves;
+
+    TEST_ASSERT_EQUAL(2, *chained);
+    TEST_ASSERT_EQUAL(2, *fused);
+
+    // the Big built by make() is only moved into its Result
+    TEST_ASSERT_EQUAL(1, fused_moves);
+    TEST_ASSERT_TRUE(fused_moves < chained_moves);
+}
+
+}  // namespace exec
+
+TESTS_MAIN
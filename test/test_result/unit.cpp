@@ -304,6 +304,92 @@ TEST_F(t_result, result_move_assign) {
     }
 }
 
+enum class Color : uint8_t { Red, Green, Blue };
+
+template <>
+struct ResultNiche<Color> : EnumNiche<Color, 3> {};
+
+static_assert(sizeof(Result<int*>) == sizeof(int*));
+static_assert(sizeof(Result<int&>) == sizeof(int*));
+static_assert(sizeof(Result<bool>) == 1);
+static_assert(sizeof(Result<Color>) == 1);
+static_assert(sizeof(Result<Dummy>) > sizeof(Dummy));
+
+TEST(result_niche_pointer) {
+    int x = 0;
+
+    SECTION("default") {
+        Result<int*> r;
+        TEST_ASSERT_EQUAL(ErrCode::Unknown, r.code());
+    }
+
+    SECTION("null is a value") {
+        Result<int*> r{static_cast<int*>(nullptr)};
+        TEST_ASSERT_TRUE(r.hasValue());
+        TEST_ASSERT_TRUE(*r == nullptr);
+    }
+
+    SECTION("errors") {
+        const auto code = GENERATE(ErrCode::Unknown, ErrCode::Cancelled, ErrCode::Lagged);
+        Result<int*> r{&x};
+        r.setError(code);
+        TEST_ASSERT_EQUAL(code, r.code());
+
+        r.emplace(&x);
+        TEST_ASSERT_TRUE(*r == &x);
+    }
+
+    SECTION("move leaves Unknown") {
+        Result<int*> r{&x};
+        Result<int*> u = std::move(r);
+        TEST_ASSERT_TRUE(*u == &x);
+        TEST_ASSERT_EQUAL(ErrCode::Unknown, r.code());
+
+        Result<int*> e{ErrCode::Cancelled};
+        u = std::move(e);
+        TEST_ASSERT_EQUAL(ErrCode::Cancelled, u.code());
+        TEST_ASSERT_EQUAL(ErrCode::Unknown, e.code());
+    }
+}
+
+TEST(result_niche_reference) {
+    int x = 1;
+    Result<int&> r{x};
+    TEST_ASSERT_TRUE(r.hasValue());
+    TEST_ASSERT_EQUAL(1, *r);
+
+    r.setError(ErrCode::Exhausted);
+    TEST_ASSERT_EQUAL(ErrCode::Exhausted, r.code());
+
+    r.emplace(x);
+    int& y = std::move(r).get();
+    TEST_ASSERT_TRUE(&y == &x);
+    TEST_ASSERT_EQUAL(ErrCode::Unknown, r.code());
+
+    Result<int&> d;
+    TEST_ASSERT_EQUAL(ErrCode::Unknown, d.code());
+}
+
+TEST(result_niche_values) {
+    SECTION("bool") {
+        Result<bool> r{false};
+        TEST_ASSERT_TRUE(r.hasValue());
+        TEST_ASSERT_FALSE(*r);
+        r.setError(ErrCode::OutOfMemory);
+        TEST_ASSERT_EQUAL(ErrCode::OutOfMemory, r.code());
+    }
+
+    SECTION("enum") {
+        const auto color = GENERATE(Color::Red, Color::Green, Color::Blue);
+        Result<Color> r{color};
+        TEST_ASSERT_TRUE(r.hasValue());
+        TEST_ASSERT_TRUE(*r == color);
+
+        r = err<Color>(ErrCode::Deadlock);
+        TEST_ASSERT_EQUAL(ErrCode::Deadlock, r.code());
+    }
+}
+
 }  // namespace exec
 
 TESTS_MAIN
@@ -0,0 +1,226 @@
+#include <exec/coro/Async.h>
+#include <exec/coro/ManualTask.h>
+#include <exec/coro/sync/Event.h>
+#include <exec/executor/SystemExecutor.h>
+#include <exec/os/OS.h>
+#include <exec/os/TimerService.h>
+#include <exec/trace/export.h>
+
+#include "coro/test.h"
+
+#include <utest/utest.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace exec {
+
+using Ev = trace::Event;
+
+struct t_trace : t_coro {
+    t_trace() { trace::clear(); }
+
+    static std::vector<trace::Record> records() {
+        std::vector<trace::Record> res;
+        trace::forEach([&res](const trace::Record& r) { res.push_back(r); });
+        return res;
+    }
+
+    // The frame created first since the start of the test
+    static const void* firstFrame() {
+        auto all = records();
+        auto it = std::find_if(
+            all.begin(), all.end(), [](auto& r) { return r.event == Ev::FrameCreate; });
+        return it != all.end() ? it->object : nullptr;
+    }
+
+    // Events recorded for the object in order
+    static std::vector<Ev> eventsOf(const void* object) {
+        std::vector<Ev> res;
+        trace::forEach([&](const trace::Record& r) {
+            if (r.object == object) {
+                res.push_back(r.event);
+            }
+        });
+        return res;
+    }
+};
+
+#if EXEC_TRACE
+
+Async<> waitEvent(Event* event) {
+    co_await event->wait();
+}
+
+TEST_F(t_trace, async_frame) {
+    Event event;
+    auto task = makeManualTask(waitEvent(&event));
+    const void* frame = firstFrame();
+
+    // the frame is created before the task starts
+    TEST_ASSERT_EQUAL(1, trace::size());
+
+    task.start();
+    event.set();
+    TEST_ASSERT_TRUE(task.done());
+
+    auto events = eventsOf(frame);
+    TEST_ASSERT_EQUAL(5, events.size());
+    TEST_ASSERT_TRUE(events[0] == Ev::FrameCreate);
+    TEST_ASSERT_TRUE(events[1] == Ev::FrameResume);
+    TEST_ASSERT_TRUE(events[2] == Ev::FrameSuspend);
+    TEST_ASSERT_TRUE(events[3] == Ev::FrameResume);
+    TEST_ASSERT_TRUE(events[4] == Ev::FrameDestroy);
+}
+
+TEST_F(t_trace, ready_await_is_not_a_suspension) {
+    Event event;
+    event.set();
+
+    auto task = makeManualTask(waitEvent(&event));
+    const void* frame = firstFrame();
+    task.start();
+    TEST_ASSERT_TRUE(task.done());
+
+    auto events = eventsOf(frame);
+    TEST_ASSERT_EQUAL(3, events.size());
+    TEST_ASSERT_TRUE(events[0] == Ev::FrameCreate);
+    TEST_ASSERT_TRUE(events[1] == Ev::FrameResume);
+    TEST_ASSERT_TRUE(events[2] == Ev::FrameDestroy);
+}
+
+TEST_F(t_trace, executor_and_timers) {
+    OS os;
+    SystemExecutor executor;
+    HeapTimerService<2> timers;
+    os.addService(&executor);
+    os.addService(&timers);
+
+    struct Timer : TimerEntry {
+        void run() override { service<Executor>()->post(&task); }
+        RunnableOf<void (*)(Runnable*)> task{[](Runnable*) {}};
+    };
+
+    Timer fired;
+    Timer cancelled;
+    fired.at = ttime::mono::now() + ttime::Duration(10);
+    cancelled.at = ttime::mono::now() + ttime::Duration(20);
+    TEST_ASSERT_TRUE(timers.add(&fired));
+    TEST_ASSERT_TRUE(timers.add(&cancelled));
+    TEST_ASSERT_TRUE(timers.remove(&cancelled));
+    TEST_ASSERT_FALSE(timers.remove(&cancelled));
+
+    ttime::mono::advance(ttime::Duration(10));
+    os.tick();  // fires the timer
+    os.tick();  // runs the posted task
+
+    auto eq = [](const std::vector<Ev>& a, std::initializer_list<Ev> b) {
+        return std::equal(a.begin(), a.end(), b.begin(), b.end());
+    };
+
+    TEST_ASSERT_TRUE(eq(eventsOf(&fired), {Ev::TimerAdd, Ev::TimerFire}));
+    TEST_ASSERT_TRUE(eq(eventsOf(&cancelled), {Ev::TimerAdd, Ev::TimerCancel}));
+    TEST_ASSERT_TRUE(eq(eventsOf(&fired.task), {Ev::Post, Ev::Run}));
+    TEST_ASSERT_TRUE(eq(eventsOf(static_cast<Service*>(&timers)),
+        {Ev::TickBegin, Ev::TickEnd, Ev::TickBegin, Ev::TickEnd}));
+
+    // the fire is recorded inside of the timer service's tick
+    auto all = records();
+    auto fire = std::find_if(all.begin(), all.end(), [](auto& r) { return r.event == Ev::TimerFire; });
+    TEST_ASSERT_TRUE(fire != all.begin() && fire != all.end());
+    TEST_ASSERT_TRUE((fire - 1)->event == Ev::TickBegin);
+    TEST_ASSERT_TRUE((fire - 1)->object == static_cast<Service*>(&timers));
+}
+
+TEST_F(t_trace, ring_keeps_newest) {
+    int objects[EXEC_TRACE_CAPACITY + 3];
+
+    for (auto& o : objects) {
+        trace::record(Ev::Post, &o);
+    }
+
+    TEST_ASSERT_EQUAL(EXEC_TRACE_CAPACITY, trace::size());
+    TEST_ASSERT_EQUAL(3, trace::dropped());
+
+    auto all = records();
+    TEST_ASSERT_TRUE(all.front().object == &objects[3]);
+    TEST_ASSERT_TRUE(all.back().object == &objects[EXEC_TRACE_CAPACITY + 2]);
+
+    trace::clear();
+    TEST_ASSERT_EQUAL(0, trace::size());
+    TEST_ASSERT_EQUAL(0, trace::dropped());
+}
+
+TEST_F(t_trace, binary_dump) {
+    int a = 0;
+    int b = 0;
+    trace::record(Ev::Post, &a);
+    trace::record(Ev::Run, &b);
+
+    struct Out {
+        void write(const uint8_t* data, size_t len) { bytes.insert(bytes.end(), data, data + len); }
+        std::vector<uint8_t> bytes;
+    } out;
+
+    trace::dumpBinary(out);
+
+    constexpr size_t header = 4 + 2 * sizeof(uint32_t);
+    constexpr size_t record = sizeof(uint32_t) + sizeof(void*) + 1;
+    TEST_ASSERT_EQUAL(header + 2 * record, out.bytes.size());
+    TEST_ASSERT_EQUAL('E', out.bytes[0]);
+    TEST_ASSERT_EQUAL('T', out.bytes[1]);
+    TEST_ASSERT_EQUAL(2, out.bytes[4]);
+    TEST_ASSERT_EQUAL(uint8_t(Ev::Run), out.bytes.back());
+}
+
+TEST_F(t_trace, chrome_trace) {
+    Event event;
+    auto task = makeManualTask(waitEvent(&event));
+    const void* frame = firstFrame();
+    task.start();
+    event.set();
+
+    char buf[4096] = {};
+    std::FILE* out = fmemopen(buf, sizeof(buf) - 1, "w");
+    trace::writeChromeTrace(out);
+    std::fclose(out);
+
+    const std::string json = buf;
+    TEST_ASSERT_EQUAL(0, json.find("{\"traceEvents\":["));
+
+    auto count = [&json](const char* s) {
+        size_t n = 0;
+        for (auto pos = json.find(s); pos != std::string::npos; pos = json.find(s, pos + 1)) {
+            ++n;
+        }
+        return n;
+    };
+
+    // two slices of the frame running
+    TEST_ASSERT_EQUAL(2, count("\"ph\":\"B\""));
+    TEST_ASSERT_EQUAL(2, count("\"ph\":\"E\""));
+    TEST_ASSERT_EQUAL(1, count("\"name\":\"create\""));
+    TEST_ASSERT_EQUAL(1, count("\"name\":\"destroy\""));
+
+    // all of them on the track of the frame
+    const std::string track = "\"tid\":" + std::to_string(reinterpret_cast<uintptr_t>(frame)) + ",";
+    TEST_ASSERT_EQUAL(6, count(track.c_str()));
+}
+
+#else
+
+TEST_F(t_trace, disabled) {
+    int a = 0;
+    trace::record(Ev::Post, &a);
+
+    TEST_ASSERT_EQUAL(0, trace::size());
+    TEST_ASSERT_EQUAL(0, records().size());
+}
+
+#endif
+
+}  // namespace exec
+
+TESTS_MAIN